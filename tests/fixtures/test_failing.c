@@ -0,0 +1,54 @@
+#include "../unit_test.h"
+
+#include <signal.h>
+#include <unistd.h>
+
+// This fixture is built apart from the example, via make test-failing, which runs it and checks the report.
+// Its test cases fail on purpose, so that the paths of the runner that only failures exercise are tested too.
+UNIT_TEST (PassingSuite, test_pass_0)
+{
+    assertEqual(1, 1);
+}
+
+UNIT_TEST (PassingSuite, test_pass_1)
+{
+    assertEqual(2, 2);
+}
+
+UNIT_TEST (PassingSuite, test_pass_2)
+{
+    assertEqual(3, 3);
+}
+
+UNIT_TEST (PassingSuite, test_slow)
+{
+    // This test case is slow enough that a baseline, wherein it was fast, is a significant regression.
+    nanosleep(&(struct timespec) { 0, 10000000 }, NULL);
+}
+
+UNIT_TEST (FailingSuite, test_fail)
+{
+    assertEqual(1, 2, "The fixture fails on purpose.");
+}
+
+UNIT_TEST (FailingSuite, test_crash)
+{
+    // The output before the crash must still be reported, even though the worker dies.
+    printf("About to crash.\n");
+    fflush(stdout);
+    raise(SIGSEGV);
+}
+
+UNIT_TEST (HangingSuite, test_hang)
+{
+    // This test case never returns, so it is only run isolated, with a timeout.
+    for (;;)
+    {
+        pause();
+    }
+}
+
+int main (int argc, const char** argv)
+{
+    return unit_test_run(argc, argv);
+}
@@ -0,0 +1,18 @@
+#include "../../src/example.h"
+
+// This test module is built apart from the program, via make module, and loaded at runtime, via --module.
+// Its test cases register themselves, and fib() is resolved from the program, which exports it.
+UNIT_TEST (ModuleSuite, test_module_fib)
+{
+    assertEqual(13, fib(7));
+}
+
+UNIT_TEST (ModuleSuite, test_module_fib_table)
+{
+    static const int expected[] = { 0, 1, 1, 2, 3, 5, 8, 13, 21, 34 };
+
+    for (unsigned int n = 0; n < sizeof(expected) / sizeof(expected[0]); n++)
+    {
+        assertEqual(expected[n], fib(n), "fib(%u) != %d", n, expected[n]);
+    }
+}
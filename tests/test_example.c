@@ -30,6 +30,120 @@ static void test_additive_case ()
     assertEqual(5, fib(5), "5 != %d", fib(5));
 }
 
+static void test_no_allocations ()
+{
+    assertEqual(55, fib(10));
+
+    // The heap allocations made by the test case are counted, given --track-resources,
+    // or else once it asserts on them, so a hot path can be locked in as allocation-free.
+    assertNoAllocations();
+    assertNoLeaks();
+}
+
+static int* fib_memo;
+
+static void setup_memo ()
+{
+    // Memory allocated from the arena is released after the teardown,
+    // even if an assertion fails, so it need not (and must not) be freed.
+    fib_memo = unit_test_calloc(21, sizeof(int));
+}
+
+static void test_arena_memo ()
+{
+    // Given --trace, this marks a span, which ends with the enclosing block.
+    UNIT_TRACE_SCOPE("memoize");
+
+    for (int n = 0; n <= 20; n++)
+    {
+        fib_memo[n] = n < 2 ? n : fib_memo[n - 1] + fib_memo[n - 2];
+    }
+
+    assertEqual(fib(20), fib_memo[20]);
+}
+
+static void test_virtual_sleep ()
+{
+    // In a virtual-time test case, sleeping merely advances the virtual clock,
+    // so that simulated delays, such as timeouts and backoff, take no real time.
+    int64_t start = unit_test_clock_now();
+    nanosleep(&(struct timespec) { 60, 0 }, NULL);
+    assertEqual(60000000000LL, unit_test_clock_now() - start);
+}
+
+typedef struct
+{
+    int n;
+    int expected;
+} fib_row_t;
+
+static const fib_row_t fib_rows[] = { { 0, 0 }, { 1, 1 }, { 2, 1 }, { 5, 5 }, { 10, 55 }, { 20, 6765 } };
+
+static void test_fib_table (const unit_test_row_t* row)
+{
+    // This function is invoked once per row of the table.
+    const fib_row_t* data = row->data;
+    assertEqual(data->expected, fib(data->n), "fib(%d) != %d", data->n, data->expected);
+}
+
+static void test_fib_corpus (const unit_test_row_t* row)
+{
+    // Each row of a data file is the NUL-terminated text of a line therein.
+    int n = 0;
+    int expected = 0;
+    assertEqual(2, sscanf(row->data, "%d %d", &n, &expected), "Malformed row: %s", (const char*) row->data);
+    assertEqual(expected, fib(n), "fib(%d) != %d", n, expected);
+}
+
+static void test_additive_property (const unit_test_value_t* values)
+{
+    // This function is invoked repeatedly with a generated value of n.
+    unsigned int n = (unsigned int) values[0].integer;
+    assertEqual(fib(n) + fib(n + 1), fib(n + 2), "n = %u", n);
+}
+
+static void test_fib_concurrent (int32_t thread)
+{
+    // This function is invoked by every thread at once, so it must be reentrant.
+    assertEqual(55, fib(10), "thread %d", thread);
+}
+
+// This test case registers itself, so it need not be declared below.
+UNIT_TEST (ExampleSuite, test_self_registered)
+{
+    assertEqual(8, fib(6));
+}
+
+static void bench_fib_15 ()
+{
+    // Prevent the otherwise unused result from being optimized away.
+    UNIT_BENCH_DO_NOT_OPTIMIZE(fib(15));
+}
+
+static void complexity_fib (int64_t n)
+{
+    // This function is invoked repeatedly with geometrically increasing sizes n.
+    UNIT_BENCH_DO_NOT_OPTIMIZE(fib((int) n));
+    assertComplexityAtMost(O_2_N);
+}
+
+static void complexity_fib_iterative (int64_t n)
+{
+    // Unlike the recursive fib(), this is linear, so the bound fails, if the loop ever becomes nested.
+    uint64_t previous = 0;
+    uint64_t current = 1;
+
+    for (int64_t k = 0; k < n; k++)
+    {
+        uint64_t next = previous + current;
+        previous = current;
+        current = next;
+    }
+
+    UNIT_BENCH_DO_NOT_OPTIMIZE(previous);
+    assertComplexityAtMost(O_N);
+}
+
 void declare_tests ()
 {
     UNIT_TEST_CASE_WITH (ExampleSuite, test_basecase_0, setup, teardown);
@@ -37,4 +151,28 @@ void declare_tests ()
 
     // If no setup/teardown is needed, then simply...
     UNIT_TEST_CASE (ExampleSuite, test_additive_case);
+    UNIT_TEST_CASE (ExampleSuite, test_no_allocations);
+
+    // Fixtures can allocate from the arena, which is reset after each test case.
+    UNIT_TEST_CASE_WITH (ExampleSuite, test_arena_memo, setup_memo, NULL);
+
+    // Virtual-time test cases read a clock, which only advances when the test case sleeps or advances it.
+    UNIT_TEST_VIRTUAL_CASE (ExampleSuite, test_virtual_sleep);
+
+    // Table-driven test cases are invoked once per row of an array (or lines of a data file).
+    UNIT_TEST_TABLE (ExampleSuite, test_fib_table, fib_rows);
+    UNIT_TEST_DATA_FILE (ExampleSuite, test_fib_corpus, "fib.txt");
+
+    // Properties are checked against many generated inputs, which are shrunk upon failure.
+    UNIT_TEST_PROPERTY (ExampleSuite, test_additive_property, UNIT_GEN_INT(0, 15));
+
+    // Concurrent test cases are invoked by several threads at once, in rounds.
+    UNIT_TEST_CONCURRENT (ExampleSuite, test_fib_concurrent, 4);
+
+    // Benchmarks are declared and selected just like test cases.
+    UNIT_BENCH_CASE (ExampleBench, bench_fib_15);
+
+    // Complexity test cases fit the growth of the cost of a function in the size of its input.
+    UNIT_TEST_COMPLEXITY (ExampleBench, complexity_fib, 3, 24);
+    UNIT_TEST_COMPLEXITY (ExampleBench, complexity_fib_iterative, 64, 65536);
 }
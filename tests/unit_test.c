@@ -25,19 +25,127 @@
 //
 #ifndef SKIP_UNIT_TESTS
 
+#define _GNU_SOURCE
+
 #include "unit_test.h"
 
+#include <dirent.h>
+#include <dlfcn.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <ftw.h>
+#include <link.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <stddef.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#endif
+
+#if defined(__GLIBC__) && defined(UNIT_TEST_INTERPOSE)
+// The real allocator, to which the interposed allocation functions forward,
+// and which allocates the start of a thread, without counting it against the test case.
+extern void* __libc_malloc (size_t size);
+extern void* __libc_calloc (size_t count, size_t size);
+extern void* __libc_realloc (void* pointer, size_t size);
+extern void* __libc_memalign (size_t alignment, size_t size);
+extern void __libc_free (void* pointer);
+#endif
+
 /**
- * These are the test cases that can be executed when running tests.
+ * These are the descriptions of the test cases that can be executed when running tests,
+ * namely the names and results thereof, which are indexed in the order of declaration.
  *
- * I am using a globally allocated array, as the number of test cases
- * is usually well below the set max and doing so avoids the need to
- * have the user of this library explicitly free the array in order
+ * The table is append-only and grows geometrically, as test cases are declared,
+ * so declaring a test case is O(1) amortized, and there is no maximum count.
+ * The table is released at exit, because doing so avoids the need to
+ * have the user of this library explicitly free the table in order
  * to avoid valgrind errors. A unit-test library should be seen and
  * not heard, while also requiring the absolute minimum code on the
  * side of the user.
  */
-static unit_test_case_t unit_test_cases[UNIT_TEST_MAX_COUNT];
+static unit_test_case_t* unit_test_cases;
+
+/**
+ * These are the parts of the test cases that are accessed when selecting
+ * and executing the test cases, which are indexed in parallel with the
+ * descriptions above. Keeping them apart keeps the scans thereof compact.
+ */
+static unit_test_case_hot_t* unit_test_hot;
+
+/**
+ * This is the number of test cases that have been declared.
+ */
+static int32_t unit_test_count;
+
+/**
+ * This is the number of test cases that the tables can hold before growing.
+ */
+static int32_t unit_test_capacity;
+
+/**
+ * A hash index over the declared test cases, which maps a key,
+ * such as the name of a suite, to the test cases that have that key.
+ */
+typedef struct
+{
+    /**
+     * This is the open-addressed hash table, whose size is a power of two.
+     * Each bucket is either empty (-1) or the first test case with a key.
+     */
+    int32_t* buckets;
+
+    /**
+     * This is the number of buckets minus one.
+     */
+    uint32_t mask;
+
+    /**
+     * This is, per test case, the next test case with the same key, or -1.
+     */
+    int32_t* next;
+
+} unit_test_index_t;
+
+/**
+ * This index maps the name of a suite to the test cases in the suite.
+ */
+static unit_test_index_t unit_test_suite_index;
+
+/**
+ * This index maps the name of a suite and test case to the test case.
+ */
+static unit_test_index_t unit_test_case_index;
+
+/**
+ * This is the number of test cases, which were declared when the indexes were built.
+ * The indexes are rebuilt, if test cases were declared thereafter.
+ */
+static int32_t unit_test_indexed_count = -1;
+
+/**
+ * This is the test module (shared object) that is declaring test cases, numbered from one, or zero for the program.
+ */
+static int32_t unit_test_declaring_module;
+
+/**
+ * This is true, if the runner is resident, whereupon the global fixtures are only executed
+ * once for all of the commands, rather than once per run.
+ */
+static bool unit_test_resident;
 
 /**
  * When tests are being executed, this is the index,
@@ -46,7 +154,229 @@ static unit_test_case_t unit_test_cases[UNIT_TEST_MAX_COUNT];
  */
 static int32_t unit_test_current;
 
-static jmp_buf unit_test_jump_point;
+/**
+ * This is where the first failed assertion of the test case that is executing is recorded, if any.
+ * This is NULL outside of a test case, such as while executing the global fixtures.
+ */
+static unit_test_failure_t* unit_test_failure;
+
+/**
+ * This is where a failed assertion jumps to, which is thread-local,
+ * since an assertion must never jump onto the stack of another thread.
+ */
+static __thread jmp_buf unit_test_jump_point;
+
+/**
+ * True, if the current thread is executed by this library, and thus has a jump point.
+ * An assertion that fails on any other thread, such as a thread started by a test case,
+ * is recorded in unit_test_thread_failures and ends the thread, rather than jumping.
+ */
+static __thread bool unit_test_runner_thread;
+
+/**
+ * This is the number of assertions that failed on threads started by the current test case,
+ * and the generation of the current test case, which is numbered anew whenever a test case executes,
+ * or zero between test cases. Both are guarded by the lock, so that each failure is counted
+ * against the generation, in which it was checked.
+ */
+static int32_t unit_test_thread_failures;
+static int64_t unit_test_generation;
+static int64_t unit_test_generation_count;
+static pthread_mutex_t unit_test_generation_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * This is the generation of the test case that started the current thread, directly or indirectly,
+ * which is captured when the thread is created, or zero, if the thread was started outside of a test case.
+ */
+static __thread int64_t unit_test_thread_generation;
+
+/**
+ * True, if failed assertions shall not be printed, such as after
+ * the first few failed rows of a table-driven test case.
+ */
+static __thread bool unit_test_quiet_failures;
+
+/**
+ * This is the number of rounds of each concurrent test case.
+ */
+static int32_t unit_test_rounds = UNIT_TEST_DEFAULT_ROUNDS;
+
+/**
+ * These are the first and last rows of the table-driven test cases, which shall be executed.
+ */
+static int64_t unit_test_first_row;
+static int64_t unit_test_last_row = INT64_MAX;
+
+/**
+ * This is the seed of the inputs of the property-based test cases,
+ * which is chosen anew for each run, unless given via --seed.
+ */
+static uint64_t unit_test_seed;
+
+/**
+ * This is the maximum number of times that each property is run.
+ */
+static uint64_t unit_test_property_runs = UNIT_TEST_DEFAULT_PROPERTY_RUNS;
+
+/**
+ * This is the time budget of each property, excluding the shrinking.
+ */
+static int64_t unit_test_property_time_ns = UNIT_TEST_DEFAULT_PROPERTY_TIME_MS * 1000000LL;
+
+/**
+ * This is the worst acceptable growth of the current complexity test case, which the function thereof
+ * declared via assertComplexityAtMost(), if any, and where the assertion is.
+ */
+static bool unit_test_complexity_bounded;
+static unit_test_complexity_t unit_test_complexity_bound;
+static const char* unit_test_complexity_file;
+static int32_t unit_test_complexity_line;
+
+/**
+ * These are the buffers of the generated inputs, and of the smallest counterexample found so far,
+ * which are static, so that generating the inputs of a property never allocates memory.
+ */
+static uint8_t unit_test_generated[UNIT_TEST_MAX_GENERATORS][UNIT_TEST_MAX_GENERATED_SIZE + 1];
+static uint8_t unit_test_counterexample[UNIT_TEST_MAX_GENERATORS][UNIT_TEST_MAX_GENERATED_SIZE + 1];
+
+/**
+ * This is a function to invoke once, before any test case is executed,
+ * to perform expensive initialization shared by all of the test cases.
+ */
+static unit_test_function_t unit_test_global_setup;
+
+/**
+ * This is a function to invoke once, after all test cases are executed,
+ * to deallocate the resources allocated by the global setup function.
+ */
+static unit_test_function_t unit_test_global_teardown;
+
+/**
+ * The fixture of a suite, which is invoked once around all of the test cases in the suite.
+ */
+typedef struct
+{
+    /**
+     * This is the name of the suite.
+     */
+    const char* suite;
+
+    /**
+     * This is a function to invoke once, before the first test case in the suite.
+     */
+    unit_test_function_t setup;
+
+    /**
+     * This is a function to invoke once, after the last test case in the suite.
+     */
+    unit_test_function_t teardown;
+
+    /**
+     * True, if the setup function failed, in which case the test cases are not executed.
+     */
+    bool setup_failed;
+
+    /**
+     * True, if the setup function succeeded, but the teardown function has not yet been invoked.
+     */
+    bool active;
+
+} unit_test_suite_fixture_t;
+
+/**
+ * These are the fixtures of the suites that have fixtures, in the order of declaration.
+ */
+static unit_test_suite_fixture_t* unit_test_suite_fixtures;
+
+/**
+ * This is the number of suite fixtures that have been declared.
+ */
+static int32_t unit_test_suite_fixture_count;
+
+/**
+ * True, if each test case shall be executed in a child process,
+ * which is forked from the runner, so that crashes are contained.
+ */
+static bool unit_test_isolate;
+
+/**
+ * When isolated, this is the maximum monotonic execution time of a test case,
+ * before the child process executing the test case is killed; otherwise, zero.
+ */
+static int64_t unit_test_timeout_ns;
+
+/**
+ * This is true, if the output of each test case is captured in memory, and only printed,
+ * along with the full report, if the test case fails, or if the run is verbose.
+ */
+static bool unit_test_capture;
+static bool unit_test_verbose;
+
+/**
+ * This is the in-memory file, to which the output of the current test case is redirected, when capturing,
+ * and the process that created it, since each worker process needs a file, and therefore an offset, of its own.
+ */
+static int unit_test_capture_fd = -1;
+static pid_t unit_test_capture_owner;
+
+/**
+ * While a test case, whose output is captured, executes in the runner itself,
+ * this is the former standard output, to which the captured output is replayed,
+ * if a fatal signal kills the runner, or else -1.
+ * The banner thereof is formatted in advance, since the signal handler cannot format it.
+ */
+static volatile int unit_test_crash_output = -1;
+static char unit_test_crash_banner[512];
+
+/**
+ * These are the fatal signals, upon which the captured output of the current test case is replayed,
+ * and the alternate stack, on which the handler runs, so that it can even report a stack overflow.
+ */
+static const int unit_test_crash_signals[] = { SIGABRT, SIGBUS, SIGFPE, SIGILL, SIGSEGV, SIGSYS, SIGTRAP };
+static char unit_test_crash_stack[256 * 1024];
+
+/**
+ * The outcome of a test case, as recorded in the state file by a previous run.
+ */
+typedef struct
+{
+    /**
+     * True, if the state file contains an entry for the test case.
+     */
+    bool present;
+
+    /**
+     * True, if the test case passed during the run that recorded the entry.
+     */
+    bool passed;
+
+    /**
+     * The elapsed time of the test case during the run that recorded the entry.
+     */
+    int64_t elapsed_time_mono_ns;
+
+    /**
+     * The build ID of the executable that recorded the entry, which is informational only,
+     * since the outcomes of the previous build are the ones worth rerunning after a rebuild.
+     */
+    char build_id[UNIT_TEST_BUILD_ID_SIZE + 1];
+
+} unit_test_history_t;
+
+/**
+ * The outcomes of the test cases during the previous run, if known, or NULL.
+ */
+static unit_test_history_t* unit_test_history;
+
+/**
+ * True, if the test cases that failed during the previous run shall be executed first.
+ */
+static bool unit_test_failed_first;
+
+/**
+ * This is the time budget of each benchmark, including the warmup.
+ */
+static int64_t unit_test_bench_time_ns = UNIT_BENCH_DEFAULT_TIME_MS * 1000000LL;
 
 int32_t unit_test_get_current ()
 {
@@ -55,13 +385,18 @@ int32_t unit_test_get_current ()
 
 unit_test_case_t* unit_test_get_cases ()
 {
-    return (unit_test_case_t*) &unit_test_cases;
+    return unit_test_cases;
+}
+
+int32_t unit_test_get_case_count ()
+{
+    return unit_test_count;
 }
 
 /**
- * A private function used to implement varadic error messages in assertions.
+ * A private function that prints the location and message of a failed assertion.
  */
-void unit_test_fail (const char* file, int32_t line, bool has_message, ...)
+static void unit_test_print_failure (const char* file, int32_t line, bool has_message, va_list va)
 {
     printf("Failed Assertion:\n");
     printf("    File: %s\n", file);
@@ -70,108 +405,8380 @@ void unit_test_fail (const char* file, int32_t line, bool has_message, ...)
     if (has_message)
     {
         printf("    Message: ");
-        va_list va;
-        va_start(va, has_message);
         char* fmt = va_arg(va, char*);
         vprintf(fmt, va);
-        va_end(va);
         printf("\n");
     }
+}
+
+/**
+ * A private function that records the location and message of the first failed assertion
+ * of the test case that is executing, if any, so that the reporters can include them.
+ */
+static void unit_test_record_failure (const char* file, int32_t line, bool has_message, va_list va)
+{
+    unit_test_failure_t* failure = unit_test_failure;
+
+    if (failure == NULL || failure->line != 0)
+    {
+        return;
+    }
+
+    failure->line = line;
+    snprintf(failure->file, sizeof(failure->file), "%s", file);
+
+    if (has_message)
+    {
+        char* fmt = va_arg(va, char*);
+        vsnprintf(failure->message, sizeof(failure->message), fmt, va);
+    }
+}
+
+/**
+ * A private function that determines whether an assertion that fails on the current thread belongs to the current test case.
+ * A thread that was started by an earlier test case, and outlived it, does not, so that its failures are not blamed on another.
+ */
+static bool unit_test_owns_thread ()
+{
+    int64_t generation = unit_test_thread_generation;
+    return unit_test_runner_thread || generation == 0 || generation == __atomic_load_n(&unit_test_generation, __ATOMIC_RELAXED);
+}
+
+/**
+ * A private function that begins a new generation, when a test case starts executing.
+ */
+static void unit_test_begin_generation ()
+{
+    pthread_mutex_lock(&unit_test_generation_lock);
+    __atomic_store_n(&unit_test_generation, ++unit_test_generation_count, __ATOMIC_RELAXED);
+    unit_test_thread_failures = 0;
+    pthread_mutex_unlock(&unit_test_generation_lock);
+}
+
+/**
+ * A private function that ends the generation of a test case, once it finishes executing.
+ * The return value is the number of assertions that failed on the threads started by the test case.
+ */
+static int32_t unit_test_end_generation ()
+{
+    pthread_mutex_lock(&unit_test_generation_lock);
+    int32_t failures = unit_test_thread_failures;
+    unit_test_thread_failures = 0;
+    __atomic_store_n(&unit_test_generation, 0, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&unit_test_generation_lock);
+    return failures;
+}
+
+#if defined(__GLIBC__) && defined(UNIT_TEST_INTERPOSE)
+
+/**
+ * The function of the C library, which is interposed below, so that each thread is tagged with the generation
+ * of the test case that started it. This is resolved upon first use.
+ */
+typedef int (*unit_test_pthread_create_t)(pthread_t* thread, const pthread_attr_t* attributes, void* (*start)(void*), void* argument);
+
+static unit_test_pthread_create_t unit_test_real_pthread_create;
+
+/**
+ * The function and argument, with which a thread was created, and the generation of the creator thereof.
+ */
+typedef struct
+{
+    void* (*start)(void*);
+    void* argument;
+    int64_t generation;
+
+} unit_test_thread_start_t;
+
+/**
+ * A private function that starts a thread, which was created via pthread_create(), after tagging it.
+ */
+static void* unit_test_start_thread (void* argument)
+{
+    unit_test_thread_start_t start = *(unit_test_thread_start_t*) argument;
+    __libc_free(argument);
+    unit_test_thread_generation = start.generation;
+    return start.start(start.argument);
+}
+
+int pthread_create (pthread_t* thread, const pthread_attr_t* attributes, void* (*start)(void*), void* argument)
+{
+    unit_test_pthread_create_t real = __atomic_load_n(&unit_test_real_pthread_create, __ATOMIC_RELAXED);
+
+    if (real == NULL)
+    {
+        real = (unit_test_pthread_create_t) dlsym(RTLD_NEXT, "pthread_create");
+        __atomic_store_n(&unit_test_real_pthread_create, real, __ATOMIC_RELAXED);
+    }
+
+    unit_test_thread_start_t* trampoline = real != NULL ? __libc_malloc(sizeof(unit_test_thread_start_t)) : NULL;
+
+    if (trampoline == NULL)
+    {
+        return EAGAIN;
+    }
+
+    // A thread started by a thread of a test case belongs to that test case too.
+    trampoline->start = start;
+    trampoline->argument = argument;
+    trampoline->generation = unit_test_runner_thread ? __atomic_load_n(&unit_test_generation, __ATOMIC_RELAXED) : unit_test_thread_generation;
+
+    int status = real(thread, attributes, unit_test_start_thread, trampoline);
+
+    if (status != 0)
+    {
+        __libc_free(trampoline);
+    }
+
+    return status;
+}
+
+#endif
+
+/**
+ * A private function that ends the execution of a failed assertion,
+ * by jumping back into this library, or by ending the thread,
+ * if the thread was started by the test case itself.
+ */
+static void unit_test_abort_assertion ()
+{
+    if (unit_test_runner_thread == false)
+    {
+        // The test case that started this thread fails, once it finishes, unless the thread outlived it.
+        pthread_mutex_lock(&unit_test_generation_lock);
+
+        if (unit_test_owns_thread())
+        {
+            ++unit_test_thread_failures;
+        }
+
+        pthread_mutex_unlock(&unit_test_generation_lock);
+        pthread_exit(NULL);
+    }
+
+    longjmp(unit_test_jump_point, 1);
+}
+
+/**
+ * A private function that prints and records a failed assertion, unless failures are quiet,
+ * or the current thread outlived its test case, but does not end the execution thereof,
+ * so that a failure can be reported once the test case has finished, such as an exceeded bound.
+ */
+static void unit_test_vreport_failure (const char* file, int32_t line, bool has_message, va_list va)
+{
+    // Keep the report of the failure together, even if assertions fail on several threads at once.
+    flockfile(stdout);
+
+    if (unit_test_quiet_failures == false && unit_test_owns_thread())
+    {
+        va_list copy;
+        va_copy(copy, va);
+        unit_test_print_failure(file, line, has_message, copy);
+        va_end(copy);
+        unit_test_record_failure(file, line, has_message, va);
+    }
+
+    funlockfile(stdout);
+}
+
+/**
+ * A private function that reports a failed assertion, like unit_test_fail(), without ending the execution of the test case.
+ */
+static void unit_test_report_failure (const char* file, int32_t line, bool has_message, ...)
+{
+    va_list va;
+    va_start(va, has_message);
+    unit_test_vreport_failure(file, line, has_message, va);
+    va_end(va);
+}
+
+void unit_test_fail (const char* file, int32_t line, bool has_message, ...)
+{
+    va_list va;
+    va_start(va, has_message);
+    unit_test_vreport_failure(file, line, has_message, va);
+    va_end(va);
+    unit_test_abort_assertion();
+}
+
+/**
+ * A private function that finds the offset of the first byte that differs between two buffers,
+ * or the length, if none do. The buffers are first compared in large blocks via memcmp(),
+ * which is vectorized by the C library, so that only one block is scanned byte by byte.
+ */
+static size_t unit_test_find_mismatch (const uint8_t* expected, const uint8_t* actual, size_t offset, size_t length)
+{
+    const size_t block = 4096;
+
+    while (offset + block <= length && 0 == memcmp(expected + offset, actual + offset, block))
+    {
+        offset += block;
+    }
+
+    while (offset < length && expected[offset] == actual[offset])
+    {
+        ++offset;
+    }
+
+    return offset;
+}
+
+/**
+ * A private function that counts the bytes that differ between two buffers, eight bytes at a time,
+ * which the compiler can vectorize further, since the loop has no branches.
+ */
+static size_t unit_test_count_mismatches (const uint8_t* expected, const uint8_t* actual, size_t length)
+{
+    const uint64_t low = 0x7F7F7F7F7F7F7F7FULL;
+    size_t count = 0;
+    size_t i = 0;
+
+    for (; i + 8 <= length; i += 8)
+    {
+        uint64_t x;
+        uint64_t y;
+        memcpy(&x, expected + i, 8);
+        memcpy(&y, actual + i, 8);
+
+        // Set the high bit of each byte of the XOR that is non-zero.
+        uint64_t difference = x ^ y;
+        uint64_t nonzero = ((difference & low) + low) | difference;
+        count += (size_t) __builtin_popcountll(nonzero & ~low);
+    }
+
+    for (; i < length; i++)
+    {
+        count += expected[i] != actual[i] ? 1 : 0;
+    }
+
+    return count;
+}
+
+/**
+ * A private function that prints one line of a hexdump, wherein the bytes beyond the end of the buffer are blank.
+ */
+static void unit_test_print_hexdump_line (const char* label, const uint8_t* bytes, size_t length, size_t offset)
+{
+    printf("        %s %08zx ", label, offset);
+
+    for (size_t k = offset; k < offset + 16; k++)
+    {
+        k < length ? printf(" %02x", bytes[k]) : printf("   ");
+    }
+
+    printf("  |");
+
+    for (size_t k = offset; k < offset + 16 && k < length; k++)
+    {
+        putchar(bytes[k] >= 0x20 && bytes[k] < 0x7F ? bytes[k] : '.');
+    }
+
+    printf("|\n");
+}
+
+/**
+ * A private function that prints where and how two buffers differ, namely the first mismatch,
+ * the number of differing bytes, and a hexdump of the lines around the first few mismatches.
+ */
+static void unit_test_print_mismatch (const uint8_t* expected, size_t expected_length, const uint8_t* actual, size_t actual_length)
+{
+    size_t common = expected_length < actual_length ? expected_length : actual_length;
+    size_t longest = expected_length > actual_length ? expected_length : actual_length;
+    size_t first = unit_test_find_mismatch(expected, actual, 0, common);
+    size_t differences = unit_test_count_mismatches(expected, actual, common) + (longest - common);
+
+    if (expected_length != actual_length)
+    {
+        printf("    Lengths: %zu (expected) and %zu (actual)\n", expected_length, actual_length);
+    }
+
+    printf("    First Mismatch: offset %zu\n", first);
+    printf("    Differing Bytes: %zu of %zu\n", differences, longest);
+
+    size_t mismatch = first;
+
+    for (int n = 0; n < UNIT_TEST_MAX_REPORTED_MISMATCHES && mismatch < longest; n++)
+    {
+        size_t start = mismatch & ~(size_t) 15;
+        size_t end = start + 16 * UNIT_TEST_HEXDUMP_LINES;
+
+        for (size_t offset = start; offset < end && offset < longest; offset += 16)
+        {
+            char markers[16 * 3 + 1] = "";
+            size_t used = 0;
+
+            for (size_t k = offset; k < offset + 16 && k < longest; k++)
+            {
+                bool differ = k >= common || expected[k] != actual[k];
+                used = differ ? 3 * (k - offset + 1) : used;
+                memcpy(markers + 3 * (k - offset), differ ? " ^^" : "   ", 4);
+            }
+
+            markers[used] = '\0';
+
+            unit_test_print_hexdump_line("expected", expected, expected_length, offset);
+            unit_test_print_hexdump_line("actual  ", actual, actual_length, offset);
+
+            if (used > 0)
+            {
+                printf("                          %s\n", markers);
+            }
+        }
+
+        mismatch = end < common ? unit_test_find_mismatch(expected, actual, end, common) : end;
+    }
+}
+
+void unit_test_fail_mismatch (const char* file,
+                              int32_t line,
+                              const void* expected,
+                              size_t expected_length,
+                              const void* actual,
+                              size_t actual_length,
+                              bool has_message,
+                              ...)
+{
+    flockfile(stdout);
+
+    if (unit_test_quiet_failures == false && unit_test_owns_thread())
+    {
+        va_list va;
+        va_start(va, has_message);
+        unit_test_print_failure(file, line, has_message, va);
+        va_end(va);
+        unit_test_print_mismatch(expected, expected_length, actual, actual_length);
+
+        bool first = unit_test_failure != NULL && unit_test_failure->line == 0;
+        va_start(va, has_message);
+        unit_test_record_failure(file, line, has_message, va);
+        va_end(va);
+
+        // Describe the mismatch, if the assertion has no message of its own.
+        if (first && has_message == false)
+        {
+            size_t length = expected_length < actual_length ? expected_length : actual_length;
+            size_t offset = unit_test_find_mismatch(expected, actual, 0, length);
+
+            snprintf(unit_test_failure->message,
+                     sizeof(unit_test_failure->message),
+                     "The first difference is at offset %zu (expected %zu bytes, actual %zu bytes).",
+                     offset,
+                     expected_length,
+                     actual_length);
+        }
+    }
+
+    funlockfile(stdout);
+    unit_test_abort_assertion();
+}
+
+/**
+ * A private function that releases the tables of test cases at exit.
+ */
+static void unit_test_release ()
+{
+    for (int32_t i = 0; i < unit_test_count; i++)
+    {
+        free(unit_test_cases[i].complexity_cost);
+    }
+
+    free(unit_test_cases);
+    free(unit_test_hot);
+    free(unit_test_suite_fixtures);
+    free(unit_test_suite_index.buckets);
+    free(unit_test_suite_index.next);
+    free(unit_test_case_index.buckets);
+    free(unit_test_case_index.next);
+    memset(&unit_test_suite_index, 0, sizeof(unit_test_index_t));
+    memset(&unit_test_case_index, 0, sizeof(unit_test_index_t));
+    unit_test_indexed_count = -1;
+    unit_test_cases = NULL;
+    unit_test_hot = NULL;
+    unit_test_suite_fixtures = NULL;
+    unit_test_suite_fixture_count = 0;
+    unit_test_count = 0;
+    unit_test_capacity = 0;
+}
+
+/**
+ * A private function that grows the tables of test cases geometrically, if need be,
+ * so that the tables can hold at least the given number of test cases.
+ */
+static void unit_test_reserve (int32_t count)
+{
+    if (count <= unit_test_capacity)
+    {
+        return;
+    }
+
+    int32_t capacity = unit_test_capacity < UNIT_TEST_CHUNK_COUNT ? UNIT_TEST_CHUNK_COUNT : unit_test_capacity * 2;
+
+    while (capacity < count)
+    {
+        capacity *= 2;
+    }
+
+    unit_test_case_t* cases = realloc(unit_test_cases, sizeof(unit_test_case_t) * capacity);
+    unit_test_cases = cases != NULL ? cases : unit_test_cases;
+    unit_test_case_hot_t* hot = realloc(unit_test_hot, sizeof(unit_test_case_hot_t) * capacity);
+    unit_test_hot = hot != NULL ? hot : unit_test_hot;
+
+    if (cases == NULL || hot == NULL)
+    {
+        fprintf(stderr, "Unable to declare %d test cases, due to insufficient memory.\n", count);
+        exit(EXIT_FAILURE);
+    }
+
+    if (unit_test_capacity == 0)
+    {
+        atexit(unit_test_release);
+    }
+
+    unit_test_capacity = capacity;
+}
+
+/**
+ * A private function used to implement the declaration of test cases.
+ */
+void unit_test_declare (const char* suite,
+                        const char* name,
+                        unit_test_function_t function,
+                        unit_test_function_t setup,
+                        unit_test_function_t teardown)
+{
+    unit_test_reserve(unit_test_count + 1);
+
+    unit_test_case_t* test = &unit_test_cases[unit_test_count];
+    memset(test, 0, sizeof(unit_test_case_t));
+    test->suite = suite;
+    test->name = name;
+    test->module = unit_test_declaring_module;
+
+    unit_test_case_hot_t* hot = &unit_test_hot[unit_test_count];
+    hot->enabled = false;
+    hot->virtual_time = false;
+    hot->kind = UNIT_TEST_KIND_TEST;
+    hot->function = function;
+    hot->setup = setup;
+    hot->teardown = teardown;
+
+    ++unit_test_count;
+}
+
+#ifdef __ELF__
+/**
+ * These are defined by the linker, and delimit the section, wherein the UNIT_TEST macros
+ * place the descriptors of the self-registered test cases. These are weak, so that
+ * a program without any self-registered test cases still links, whereupon these are NULL.
+ */
+extern const unit_test_descriptor_t __start_unit_test_cases[] __attribute__((weak));
+extern const unit_test_descriptor_t __stop_unit_test_cases[] __attribute__((weak));
+#endif
+
+/**
+ * A private function used to sort the self-registered test cases by where they were defined.
+ */
+static int unit_test_compare_descriptor (const void* left, const void* right)
+{
+    const unit_test_descriptor_t* x = *(const unit_test_descriptor_t* const*) left;
+    const unit_test_descriptor_t* y = *(const unit_test_descriptor_t* const*) right;
+    int order = strcmp(x->file, y->file);
+    return order != 0 ? order : (x->line < y->line ? -1 : (x->line > y->line ? 1 : 0));
+}
+
+/**
+ * A private function that appends self-registered test cases to the tables of test cases,
+ * in the order of definition, from a table of descriptors that the linker built.
+ */
+static void unit_test_declare_descriptors (const unit_test_descriptor_t* start, const unit_test_descriptor_t* stop)
+{
+    int32_t count = (int32_t) (stop - start);
+    const unit_test_descriptor_t** order = malloc(sizeof(unit_test_descriptor_t*) * (count + 1));
+
+    if (order == NULL)
+    {
+        fprintf(stderr, "Unable to declare the self-registered test cases, due to insufficient memory.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    for (int32_t k = 0; k < count; k++)
+    {
+        order[k] = &start[k];
+    }
+
+    qsort(order, count, sizeof(unit_test_descriptor_t*), unit_test_compare_descriptor);
+    unit_test_reserve(unit_test_count + count);
+
+    for (int32_t k = 0; k < count; k++)
+    {
+        const unit_test_descriptor_t* descriptor = order[k];
+        unit_test_declare(descriptor->suite, descriptor->name, descriptor->function, descriptor->setup, descriptor->teardown);
+        unit_test_hot[unit_test_count - 1].kind = descriptor->kind;
+    }
+
+    free(order);
+}
+
+/**
+ * A private function that appends the self-registered test cases of the program to the tables of test cases.
+ */
+static void unit_test_declare_registered ()
+{
+#ifdef __ELF__
+    static bool declared = false;
+
+    if (declared || __start_unit_test_cases == NULL)
+    {
+        return;
+    }
+
+    declared = true;
+    unit_test_declare_descriptors(__start_unit_test_cases, __stop_unit_test_cases);
+#endif
+}
+
+/**
+ * A private function that removes the test cases of a test module from the tables of test cases,
+ * while preserving the order of the others, such as before the module is unloaded.
+ */
+static void unit_test_forget_module (int32_t module)
+{
+    int32_t kept = 0;
+
+    for (int32_t i = 0; i < unit_test_count; i++)
+    {
+        if (unit_test_cases[i].module != module)
+        {
+            unit_test_cases[kept] = unit_test_cases[i];
+            unit_test_hot[kept] = unit_test_hot[i];
+            ++kept;
+        }
+        else
+        {
+            free(unit_test_cases[i].complexity_cost);
+        }
+    }
+
+    // The indexes are rebuilt, even if the module declares the same number of test cases again.
+    unit_test_count = kept;
+    unit_test_indexed_count = -1;
+}
+
+/**
+ * A private function used to implement the declaration of benchmarks.
+ */
+void unit_test_declare_bench (const char* suite,
+                              const char* name,
+                              unit_test_function_t function,
+                              unit_test_function_t setup,
+                              unit_test_function_t teardown)
+{
+    unit_test_declare(suite, name, function, setup, teardown);
+    unit_test_hot[unit_test_count - 1].kind = UNIT_TEST_KIND_BENCH;
+}
+
+/**
+ * A private function used to implement the declaration of test cases, which run against the virtual clock.
+ */
+void unit_test_declare_virtual (const char* suite,
+                                const char* name,
+                                unit_test_function_t function,
+                                unit_test_function_t setup,
+                                unit_test_function_t teardown)
+{
+    unit_test_declare(suite, name, function, setup, teardown);
+    unit_test_hot[unit_test_count - 1].virtual_time = true;
+}
+
+/**
+ * A private function used to implement the declaration of table-driven test cases,
+ * whose rows are the elements of a static array.
+ */
+void unit_test_declare_table (const char* suite,
+                              const char* name,
+                              unit_test_row_function_t function,
+                              const void* table,
+                              int64_t row_count,
+                              size_t row_size)
+{
+    unit_test_declare(suite, name, NULL, NULL, NULL);
+    unit_test_hot[unit_test_count - 1].kind = UNIT_TEST_KIND_TABLE;
+    unit_test_cases[unit_test_count - 1].row_function = function;
+    unit_test_cases[unit_test_count - 1].table = table;
+    unit_test_cases[unit_test_count - 1].row_count = row_count;
+    unit_test_cases[unit_test_count - 1].row_size = row_size;
+}
+
+/**
+ * A private function used to implement the declaration of table-driven test cases,
+ * whose rows are the lines of a data file, which is memory-mapped when executed.
+ */
+void unit_test_declare_data_file (const char* suite,
+                                  const char* name,
+                                  unit_test_row_function_t function,
+                                  const char* path,
+                                  const char* source)
+{
+    unit_test_declare(suite, name, NULL, NULL, NULL);
+    unit_test_hot[unit_test_count - 1].kind = UNIT_TEST_KIND_TABLE;
+    unit_test_cases[unit_test_count - 1].row_function = function;
+    unit_test_cases[unit_test_count - 1].data_path = path;
+    unit_test_cases[unit_test_count - 1].data_source = source;
+}
+
+/**
+ * A private function used to implement the declaration of property-based test cases.
+ */
+void unit_test_declare_property (const char* suite,
+                                 const char* name,
+                                 unit_test_property_function_t function,
+                                 const unit_test_generator_t* generators,
+                                 int32_t generator_count)
+{
+    if (generator_count > UNIT_TEST_MAX_GENERATORS)
+    {
+        fprintf(stderr, "Property %s/%s has more than %d inputs.\n", suite, name, UNIT_TEST_MAX_GENERATORS);
+        exit(EXIT_FAILURE);
+    }
+
+    for (int32_t g = 0; g < generator_count; g++)
+    {
+        const unit_test_generator_t* generator = &generators[g];
+        bool sized = generator->kind != UNIT_TEST_GENERATOR_INTEGER;
+
+        if (generator->min > generator->max || (sized && (generator->min < 0 || generator->max > UNIT_TEST_MAX_GENERATED_SIZE)))
+        {
+            fprintf(stderr, "Property %s/%s has an invalid range for input %d.\n", suite, name, g);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    unit_test_declare(suite, name, NULL, NULL, NULL);
+    unit_test_case_t* test = &unit_test_cases[unit_test_count - 1];
+    unit_test_hot[unit_test_count - 1].kind = UNIT_TEST_KIND_PROPERTY;
+    test->property_function = function;
+    test->generator_count = generator_count;
+    memcpy(test->generators, generators, sizeof(unit_test_generator_t) * generator_count);
+}
+
+/**
+ * A private function used to implement the declaration of concurrent test cases.
+ */
+void unit_test_declare_concurrent (const char* suite,
+                                   const char* name,
+                                   unit_test_concurrent_function_t function,
+                                   int32_t threads)
+{
+    if (threads < 1 || threads > UNIT_TEST_MAX_THREADS)
+    {
+        fprintf(stderr, "Concurrent test case %s/%s must have from 1 to %d threads.\n", suite, name, UNIT_TEST_MAX_THREADS);
+        exit(EXIT_FAILURE);
+    }
+
+    unit_test_declare(suite, name, NULL, NULL, NULL);
+    unit_test_hot[unit_test_count - 1].kind = UNIT_TEST_KIND_CONCURRENT;
+    unit_test_cases[unit_test_count - 1].concurrent_function = function;
+    unit_test_cases[unit_test_count - 1].threads = threads;
+}
+
+/**
+ * A private function used to implement the declaration of complexity test cases.
+ */
+void unit_test_declare_complexity (const char* suite,
+                                   const char* name,
+                                   unit_test_complexity_function_t function,
+                                   int64_t min_n,
+                                   int64_t max_n)
+{
+    if (min_n < 1 || max_n / 4 < min_n)
+    {
+        fprintf(stderr, "Complexity test case %s/%s needs sizes from at least 1 to at least four times that.\n", suite, name);
+        exit(EXIT_FAILURE);
+    }
+
+    // Only complexity test cases pay for the costs of the input sizes.
+    double* cost = calloc(UNIT_TEST_MAX_COMPLEXITY_SIZES, sizeof(double));
+
+    if (cost == NULL)
+    {
+        fprintf(stderr, "Unable to declare complexity test case %s/%s, due to insufficient memory.\n", suite, name);
+        exit(EXIT_FAILURE);
+    }
+
+    unit_test_declare(suite, name, NULL, NULL, NULL);
+    unit_test_hot[unit_test_count - 1].kind = UNIT_TEST_KIND_COMPLEXITY;
+    unit_test_cases[unit_test_count - 1].complexity_function = function;
+    unit_test_cases[unit_test_count - 1].min_n = min_n;
+    unit_test_cases[unit_test_count - 1].max_n = max_n;
+    unit_test_cases[unit_test_count - 1].complexity_cost = cost;
+}
+
+/**
+ * A private function used to implement assertComplexityAtMost(),
+ * which merely records the bound, since the growth is only known once every size was measured.
+ */
+void unit_test_bound_complexity (const char* file, int32_t line, unit_test_complexity_t bound)
+{
+    unit_test_complexity_bounded = true;
+    unit_test_complexity_bound = bound;
+    unit_test_complexity_file = file;
+    unit_test_complexity_line = line;
+}
+
+/**
+ * A private function used to implement the declaration of global fixtures,
+ * which are invoked once per run, rather than once per test case.
+ */
+void unit_test_declare_global (unit_test_function_t setup, unit_test_function_t teardown)
+{
+    unit_test_global_setup = setup;
+    unit_test_global_teardown = teardown;
+}
+
+/**
+ * A private function used to implement the declaration of suite fixtures,
+ * which are invoked once per suite, rather than once per test case.
+ * Declaring the fixture of a suite again replaces the former fixture.
+ */
+void unit_test_declare_suite (const char* suite, unit_test_function_t setup, unit_test_function_t teardown)
+{
+    int32_t k = 0;
+
+    while (k < unit_test_suite_fixture_count && 0 != strcmp(unit_test_suite_fixtures[k].suite, suite))
+    {
+        ++k;
+    }
+
+    if (k == unit_test_suite_fixture_count)
+    {
+        unit_test_suite_fixture_t* fixtures = realloc(unit_test_suite_fixtures, sizeof(unit_test_suite_fixture_t) * (k + 1));
+
+        if (fixtures == NULL)
+        {
+            fprintf(stderr, "Unable to declare the fixture of suite %s, due to insufficient memory.\n", suite);
+            exit(EXIT_FAILURE);
+        }
+
+        if (unit_test_suite_fixtures == NULL && unit_test_capacity == 0)
+        {
+            atexit(unit_test_release);
+        }
+
+        unit_test_suite_fixtures = fixtures;
+        ++unit_test_suite_fixture_count;
+    }
+
+    unit_test_suite_fixtures[k].suite = suite;
+    unit_test_suite_fixtures[k].setup = setup;
+    unit_test_suite_fixtures[k].teardown = teardown;
+    unit_test_suite_fixtures[k].setup_failed = false;
+    unit_test_suite_fixtures[k].active = false;
+}
+
+/**
+ * A private utility function that computes the FNV-1a hash of a string,
+ * continuing from the given hash, so that keys can be hashed piecewise.
+ */
+static uint64_t unit_test_hash (uint64_t hash, const char* text)
+{
+    for (const unsigned char* p = (const unsigned char*) text; *p != '\0'; p++)
+    {
+        hash = (hash ^ *p) * 1099511628211ULL;
+    }
+
+    return hash;
+}
+
+/**
+ * The initial value of an FNV-1a hash.
+ */
+#define UNIT_TEST_HASH_SEED 14695981039346656037ULL
+
+/**
+ * A private utility function that hashes the name of a suite.
+ */
+static uint64_t unit_test_hash_suite (const char* suite)
+{
+    return unit_test_hash(UNIT_TEST_HASH_SEED, suite);
+}
+
+/**
+ * A private utility function that hashes the name of a suite and test case,
+ * as though they were a single string of the form "suite/name".
+ */
+static uint64_t unit_test_hash_case (const char* suite, const char* name)
+{
+    return unit_test_hash(unit_test_hash(unit_test_hash(UNIT_TEST_HASH_SEED, suite), "/"), name);
+}
+
+/**
+ * A private function that finds the first test case in the given suite, or -1.
+ * The rest of the test cases in the suite are then found via the index.
+ */
+static int32_t unit_test_find_suite (const char* suite)
+{
+    unit_test_index_t* index = &unit_test_suite_index;
+
+    for (uint32_t b = (uint32_t) unit_test_hash_suite(suite) & index->mask; index->buckets[b] >= 0; b = (b + 1) & index->mask)
+    {
+        if (0 == strcmp(unit_test_cases[index->buckets[b]].suite, suite))
+        {
+            return index->buckets[b];
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * A private function that finds the first test case with the given name, or -1.
+ * The rest of the test cases with the same name, if any, are then found via the index.
+ */
+static int32_t unit_test_find_case (const char* suite, const char* name)
+{
+    unit_test_index_t* index = &unit_test_case_index;
+
+    for (uint32_t b = (uint32_t) unit_test_hash_case(suite, name) & index->mask; index->buckets[b] >= 0; b = (b + 1) & index->mask)
+    {
+        unit_test_case_t* test = &unit_test_cases[index->buckets[b]];
+
+        if (0 == strcmp(test->suite, suite) && 0 == strcmp(test->name, name))
+        {
+            return index->buckets[b];
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * A private function that (re)allocates an empty index,
+ * which is large enough to hold the given number of keys.
+ */
+static void unit_test_allocate_index (unit_test_index_t* index, int32_t count)
+{
+    uint32_t size = 16;
+
+    while (size < (uint32_t) count * 2)
+    {
+        size *= 2;
+    }
+
+    free(index->buckets);
+    free(index->next);
+    index->buckets = malloc(sizeof(int32_t) * size);
+    index->next = malloc(sizeof(int32_t) * (count + 1));
+    index->mask = size - 1;
+
+    if (index->buckets == NULL || index->next == NULL)
+    {
+        fprintf(stderr, "Unable to index the test cases, due to insufficient memory.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    memset(index->buckets, -1, sizeof(int32_t) * size);
+}
+
+/**
+ * A private function that builds the hash indexes over the declared test cases,
+ * which is done once, after all of the test cases have been declared.
+ * Thereafter, a suite or test case can be found in O(1) expected time.
+ *
+ * The test cases with the same key are chained in the order of declaration.
+ */
+static void unit_test_build_indexes ()
+{
+    if (unit_test_indexed_count == unit_test_count)
+    {
+        return;
+    }
+
+    unit_test_allocate_index(&unit_test_suite_index, unit_test_count);
+    unit_test_allocate_index(&unit_test_case_index, unit_test_count);
+
+    // Iterate in reverse, so that prepending to the chains preserves the order of declaration.
+    for (int32_t i = unit_test_count - 1; i >= 0; i--)
+    {
+        unit_test_case_t* test = &unit_test_cases[i];
+        unit_test_index_t* index = &unit_test_suite_index;
+        uint32_t b = (uint32_t) unit_test_hash_suite(test->suite) & index->mask;
+
+        while (index->buckets[b] >= 0 && 0 != strcmp(unit_test_cases[index->buckets[b]].suite, test->suite))
+        {
+            b = (b + 1) & index->mask;
+        }
+
+        index->next[i] = index->buckets[b];
+        index->buckets[b] = i;
+
+        index = &unit_test_case_index;
+        b = (uint32_t) unit_test_hash_case(test->suite, test->name) & index->mask;
+
+        while (index->buckets[b] >= 0
+               && (0 != strcmp(unit_test_cases[index->buckets[b]].suite, test->suite)
+                   || 0 != strcmp(unit_test_cases[index->buckets[b]].name, test->name)))
+        {
+            b = (b + 1) & index->mask;
+        }
+
+        index->next[i] = index->buckets[b];
+        index->buckets[b] = i;
+    }
+
+    unit_test_indexed_count = unit_test_count;
+}
+
+/**
+ * A private utility function that matches text against a glob pattern,
+ * wherein '*' matches any sequence of characters and '?' matches any one character.
+ * The pattern is matched up to, but excluding, the given terminator, or the end.
+ */
+static bool unit_test_glob (const char* pattern, char terminator, const char* text)
+{
+    const char* star = NULL;
+    const char* resume = NULL;
+
+    while (*text != '\0')
+    {
+        if (*pattern == '*')
+        {
+            star = pattern++;
+            resume = text;
+        }
+        else if (*pattern != '\0' && *pattern != terminator && (*pattern == '?' || *pattern == *text))
+        {
+            ++pattern;
+            ++text;
+        }
+        else if (star != NULL)
+        {
+            pattern = star + 1;
+            text = ++resume;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    while (*pattern == '*')
+    {
+        ++pattern;
+    }
+
+    return *pattern == '\0' || *pattern == terminator;
+}
+
+/**
+ * A private function that enables, or disables, the test cases that match a filter.
+ *
+ * The filter is of the form "suite/name", wherein both parts are glob patterns.
+ * If the filter does not contain a slash, then it matches every test case in the suite(s).
+ * If the suite part is not a glob, then only the test cases in that suite are examined.
+ */
+static void unit_test_apply_filter (const char* filter, bool enabled)
+{
+    const char* slash = strchr(filter, '/');
+    const char* name_pattern = slash == NULL ? "*" : slash + 1;
+    size_t suite_length = slash == NULL ? strlen(filter) : (size_t) (slash - filter);
+
+    if (strcspn(filter, "*?") >= suite_length)
+    {
+        char suite[suite_length + 1];
+        memcpy(suite, filter, suite_length);
+        suite[suite_length] = '\0';
+
+        for (int32_t i = unit_test_find_suite(suite); i >= 0; i = unit_test_suite_index.next[i])
+        {
+            if (unit_test_glob(name_pattern, '\0', unit_test_cases[i].name))
+            {
+                unit_test_hot[i].enabled = enabled;
+            }
+        }
+    }
+    else
+    {
+        for (int32_t i = 0; i < unit_test_count; i++)
+        {
+            if (unit_test_glob(filter, '/', unit_test_cases[i].suite) && unit_test_glob(name_pattern, '\0', unit_test_cases[i].name))
+            {
+                unit_test_hot[i].enabled = enabled;
+            }
+        }
+    }
+}
+
+/**
+ * True, while a virtual-time test case is executing, such that the clocks read the virtual time, and sleeping advances it.
+ */
+static bool unit_test_virtual_active;
+
+/**
+ * The time of the virtual clock, in nanoseconds, and the difference between the real time and
+ * the monotonic time, when the virtual-time test case started, which is added to the virtual time,
+ * when the real-time clock is read, so that both clocks advance together.
+ */
+static int64_t unit_test_virtual_ns;
+static int64_t unit_test_virtual_realtime_offset_ns;
+
+#if defined(__GLIBC__) && defined(UNIT_TEST_INTERPOSE)
+
+/**
+ * The functions of the C library, which are interposed below, so that the harness can still read the real clocks,
+ * and sleep for real, outside of virtual-time test cases. These are resolved upon first use.
+ */
+typedef int (*unit_test_clock_gettime_t)(clockid_t clock, struct timespec* ts);
+typedef int (*unit_test_clock_nanosleep_t)(clockid_t clock, int flags, const struct timespec* request, struct timespec* remaining);
+
+static unit_test_clock_gettime_t unit_test_real_clock_gettime;
+static unit_test_clock_nanosleep_t unit_test_real_clock_nanosleep;
+
+/**
+ * A private function that reads a real clock, which is always used by the harness itself,
+ * so that the timings thereof are real, even while a virtual-time test case is executing.
+ */
+static int unit_test_read_clock (clockid_t clock, struct timespec* ts)
+{
+    unit_test_clock_gettime_t real = __atomic_load_n(&unit_test_real_clock_gettime, __ATOMIC_RELAXED);
+
+    if (real == NULL)
+    {
+        real = (unit_test_clock_gettime_t) dlsym(RTLD_NEXT, "clock_gettime");
+        __atomic_store_n(&unit_test_real_clock_gettime, real, __ATOMIC_RELAXED);
+    }
+
+    return real != NULL ? real(clock, ts) : (int) syscall(SYS_clock_gettime, clock, ts);
+}
+
+#else
+
+static int unit_test_read_clock (clockid_t clock, struct timespec* ts)
+{
+    return clock_gettime(clock, ts);
+}
+
+#endif
+
+/**
+ * A private utility function used to obtain the monotonic current time.
+ */
+static int64_t unit_test_monotonic ()
+{
+    struct timespec ts;
+    int status = unit_test_read_clock(CLOCK_MONOTONIC, &ts);
+    assert (status == 0);
+    (void) status;
+    return (int64_t) ts.tv_sec * (int64_t) 1000000000LL + (int64_t) ts.tv_nsec;
+}
+
+/**
+ * A private utility function used to obtain the CPU time consumed by the calling thread.
+ */
+static int64_t unit_test_thread_cpu ()
+{
+    struct timespec ts;
+
+    if (unit_test_read_clock(CLOCK_THREAD_CPUTIME_ID, &ts) != 0)
+    {
+        return 0;
+    }
+
+    return (int64_t) ts.tv_sec * (int64_t) 1000000000LL + (int64_t) ts.tv_nsec;
+}
+
+int64_t unit_test_clock_now ()
+{
+    if (__atomic_load_n(&unit_test_virtual_active, __ATOMIC_ACQUIRE))
+    {
+        return __atomic_load_n(&unit_test_virtual_ns, __ATOMIC_ACQUIRE);
+    }
+
+    return unit_test_monotonic();
+}
+
+void unit_test_clock_advance (int64_t ns)
+{
+    if (ns > 0 && __atomic_load_n(&unit_test_virtual_active, __ATOMIC_ACQUIRE))
+    {
+        __atomic_add_fetch(&unit_test_virtual_ns, ns, __ATOMIC_ACQ_REL);
+    }
+}
+
+/**
+ * A private function that starts the virtual clock at the time of the real monotonic clock.
+ */
+static void unit_test_start_virtual_clock ()
+{
+    struct timespec realtime;
+    int64_t now = unit_test_monotonic();
+
+    unit_test_read_clock(CLOCK_REALTIME, &realtime);
+    unit_test_virtual_realtime_offset_ns = (int64_t) realtime.tv_sec * 1000000000LL + realtime.tv_nsec - now;
+    __atomic_store_n(&unit_test_virtual_ns, now, __ATOMIC_RELEASE);
+    __atomic_store_n(&unit_test_virtual_active, true, __ATOMIC_RELEASE);
+}
+
+/**
+ * A private function that stops the virtual clock, such that the clocks read the real time again.
+ */
+static void unit_test_stop_virtual_clock ()
+{
+    __atomic_store_n(&unit_test_virtual_active, false, __ATOMIC_RELEASE);
+}
+
+#if defined(__GLIBC__) && defined(UNIT_TEST_INTERPOSE)
+
+/**
+ * A private function that determines whether a clock measures the passage of time,
+ * and thus reads the virtual time, rather than the CPU time of a process or thread.
+ */
+static bool unit_test_is_virtual_clock (clockid_t clock)
+{
+    return clock == CLOCK_MONOTONIC || clock == CLOCK_MONOTONIC_RAW || clock == CLOCK_MONOTONIC_COARSE
+        || clock == CLOCK_BOOTTIME || clock == CLOCK_REALTIME || clock == CLOCK_REALTIME_COARSE;
+}
+
+/**
+ * A private function that obtains the virtual time of a clock, in nanoseconds.
+ */
+static int64_t unit_test_virtual_time (clockid_t clock)
+{
+    int64_t now = __atomic_load_n(&unit_test_virtual_ns, __ATOMIC_ACQUIRE);
+    return clock == CLOCK_REALTIME || clock == CLOCK_REALTIME_COARSE ? now + unit_test_virtual_realtime_offset_ns : now;
+}
+
+int clock_gettime (clockid_t clock, struct timespec* ts)
+{
+    if (__atomic_load_n(&unit_test_virtual_active, __ATOMIC_ACQUIRE) && unit_test_is_virtual_clock(clock))
+    {
+        int64_t now = unit_test_virtual_time(clock);
+        ts->tv_sec = (time_t) (now / 1000000000LL);
+        ts->tv_nsec = (long) (now % 1000000000LL);
+        return 0;
+    }
+
+    return unit_test_read_clock(clock, ts);
+}
+
+int clock_nanosleep (clockid_t clock, int flags, const struct timespec* request, struct timespec* remaining)
+{
+    if (request->tv_nsec < 0 || request->tv_nsec >= 1000000000L || (request->tv_sec < 0 && (flags & TIMER_ABSTIME) == 0))
+    {
+        return EINVAL;
+    }
+
+    if (__atomic_load_n(&unit_test_virtual_active, __ATOMIC_ACQUIRE) && unit_test_is_virtual_clock(clock))
+    {
+        // Sleeping merely advances the virtual clock, to the given time, if absolute.
+        int64_t duration = (int64_t) request->tv_sec * 1000000000LL + request->tv_nsec;
+        unit_test_clock_advance((flags & TIMER_ABSTIME) != 0 ? duration - unit_test_virtual_time(clock) : duration);
+        return 0;
+    }
+
+    unit_test_clock_nanosleep_t real = __atomic_load_n(&unit_test_real_clock_nanosleep, __ATOMIC_RELAXED);
+
+    if (real == NULL)
+    {
+        real = (unit_test_clock_nanosleep_t) dlsym(RTLD_NEXT, "clock_nanosleep");
+        __atomic_store_n(&unit_test_real_clock_nanosleep, real, __ATOMIC_RELAXED);
+    }
+
+    return real != NULL ? real(clock, flags, request, remaining) : ENOSYS;
+}
+
+int nanosleep (const struct timespec* request, struct timespec* remaining)
+{
+    int error = clock_nanosleep(CLOCK_MONOTONIC, 0, request, remaining);
+
+    if (error != 0)
+    {
+        errno = error;
+        return -1;
+    }
+
+    return 0;
+}
+
+int usleep (useconds_t microseconds)
+{
+    struct timespec request = { (time_t) (microseconds / 1000000), (long) (microseconds % 1000000) * 1000L };
+    return nanosleep(&request, NULL);
+}
+
+unsigned int sleep (unsigned int seconds)
+{
+    struct timespec request = { (time_t) seconds, 0 };
+    struct timespec remaining = { 0, 0 };
+
+    if (nanosleep(&request, &remaining) != 0)
+    {
+        return (unsigned int) remaining.tv_sec + (remaining.tv_nsec > 0 ? 1 : 0);
+    }
+
+    return 0;
+}
+
+#endif
+
+/**
+ * A private utility function that formats a duration, given in nanoseconds,
+ * with a unit (ns, µs, ms, or s) that is appropriate for the magnitude thereof,
+ * and with about three significant digits.
+ */
+static const char* unit_test_format_time (char* buffer, size_t size, double ns)
+{
+    static const char* units[] = { "ns", "µs", "ms", "s" };
+    double value = ns;
+    int unit = 0;
+
+    while (unit < 3 && (value >= 1000.0 || value <= -1000.0))
+    {
+        value /= 1000.0;
+        ++unit;
+    }
+
+    double magnitude = value < 0 ? -value : value;
+    int precision = magnitude < 10.0 ? 2 : (magnitude < 100.0 ? 1 : 0);
+
+    snprintf(buffer, size, "%.*f %s", precision, value, units[unit]);
+    return buffer;
+}
+
+/**
+ * A private function that computes the base two logarithm, without depending on libm,
+ * by extracting the bits of the fraction via repeated squaring.
+ */
+static double unit_test_log2 (double x)
+{
+    double result = 0;
+
+    while (x >= 2)
+    {
+        x /= 2;
+        result += 1;
+    }
+
+    while (x < 1)
+    {
+        x *= 2;
+        result -= 1;
+    }
+
+    for (double bit = 0.5; bit > 1e-9; bit /= 2)
+    {
+        x *= x;
+
+        if (x >= 2)
+        {
+            x /= 2;
+            result += bit;
+        }
+    }
+
+    return result;
+}
+
+/**
+ * A private function that computes a square root, without depending on libm, via Newton's method.
+ */
+static double unit_test_sqrt (double x)
+{
+    double root = x > 1 ? x : 1;
+
+    for (int k = 0; k < 100 && x > 0; k++)
+    {
+        root = (root + x / root) / 2;
+    }
+
+    return x > 0 ? root : 0;
+}
+
+/**
+ * A private function that evaluates a growth model at the given input size.
+ * The logarithm is at least one, so that the models do not vanish at the smallest sizes.
+ * The exponential model is infinite for sizes beyond the range of a double.
+ */
+static double unit_test_growth (unit_test_complexity_t model, int64_t n)
+{
+    double x = (double) n;
+    double log_x = x > 2 ? unit_test_log2(x) : 1;
+    double power = 1;
+
+    switch (model)
+    {
+        case O_1: return 1;
+        case O_LOG_N: return log_x;
+        case O_N: return x;
+        case O_N_LOG_N: return x * log_x;
+        case O_N_SQUARED: return x * x;
+        case O_2_N:
+            for (int64_t k = 0; k < n && power < 1e300; k++)
+            {
+                power *= 2;
+            }
+
+            return power < 1e300 ? power : 1.0 / 0.0;
+    }
+
+    return 1;
+}
+
+/**
+ * A private function that obtains the name of a growth model.
+ */
+static const char* unit_test_growth_name (unit_test_complexity_t model)
+{
+    static const char* names[] = { "O(1)", "O(log n)", "O(n)", "O(n log n)", "O(n^2)", "O(2^n)" };
+    return model >= O_1 && model <= O_2_N ? names[model] : "O(?)";
+}
+
+/**
+ * A private function that obtains the k-th input size of a complexity test case.
+ */
+static int64_t unit_test_complexity_size (const unit_test_case_t* test, int32_t k)
+{
+    return test->min_n << k;
+}
+
+/**
+ * A private function that computes a power of two, without depending on libm,
+ * via the integer part of the exponent and a Taylor series of the fraction.
+ */
+static double unit_test_exp2 (double x)
+{
+    double result = 1;
+
+    for (; x >= 1 && result < 1e300; x -= 1)
+    {
+        result *= 2;
+    }
+
+    for (; x < 0 && result > 1e-300; x += 1)
+    {
+        result /= 2;
+    }
+
+    double term = 1;
+    double sum = 1;
+
+    for (int k = 1; k < 30; k++)
+    {
+        term *= x * 0.69314718055994530942 / k;
+        sum += term;
+    }
+
+    return result * sum;
+}
+
+/**
+ * A private function that fits the measured costs of a complexity test case to each growth model, via least squares
+ * in log-log space, so that every size weighs the same, rather than the largest sizes dominating the fit,
+ * and selects the model with the smallest root mean square relative error.
+ * The exponential model fits its base too, since any base greater than one is exponential.
+ * A worse model is only selected, if it fits clearly better than a better model,
+ * so that measurement noise does not make a linear function appear to be O(n log n).
+ */
+static void unit_test_fit_complexity (unit_test_case_t* test)
+{
+    unit_test_complexity_result_t* result = &test->result.complexity;
+    double log_cost[UNIT_TEST_MAX_COMPLEXITY_SIZES];
+    double mean_n = 0;
+
+    for (int32_t k = 0; k < result->sizes; k++)
+    {
+        log_cost[k] = unit_test_log2(test->complexity_cost[k] > 1e-9 ? test->complexity_cost[k] : 1e-9);
+        mean_n += (double) unit_test_complexity_size(test, k) / result->sizes;
+    }
+
+    result->fit = O_1;
+    result->rms = 1.0 / 0.0;
+
+    for (unit_test_complexity_t model = O_1; model <= O_2_N; model++)
+    {
+        double log_growth[UNIT_TEST_MAX_COMPLEXITY_SIZES];
+        double intercept = 0;
+        double rate = 0;
+
+        for (int32_t k = 0; k < result->sizes; k++)
+        {
+            int64_t n = unit_test_complexity_size(test, k);
+            log_growth[k] = model == O_2_N ? (double) n : unit_test_log2(unit_test_growth(model, n));
+        }
+
+        if (model == O_2_N)
+        {
+            // Regress the logarithm of the cost on n, whose slope is the logarithm of the base.
+            double covariance = 0;
+            double variance = 0;
+            double mean_cost = 0;
+
+            for (int32_t k = 0; k < result->sizes; k++)
+            {
+                mean_cost += log_cost[k] / result->sizes;
+            }
+
+            for (int32_t k = 0; k < result->sizes; k++)
+            {
+                covariance += (log_growth[k] - mean_n) * (log_cost[k] - mean_cost);
+                variance += (log_growth[k] - mean_n) * (log_growth[k] - mean_n);
+            }
+
+            rate = variance > 0 ? covariance / variance : 0;
+
+            if (rate <= 0)
+            {
+                continue; // The costs do not grow exponentially.
+            }
+
+            intercept = mean_cost - rate * mean_n;
+        }
+        else
+        {
+            rate = 1;
+
+            for (int32_t k = 0; k < result->sizes; k++)
+            {
+                intercept += (log_cost[k] - log_growth[k]) / result->sizes;
+            }
+        }
+
+        double error = 0;
+
+        for (int32_t k = 0; k < result->sizes; k++)
+        {
+            double residual = log_cost[k] - intercept - rate * log_growth[k];
+            error += residual * residual / result->sizes;
+        }
+
+        double rms = unit_test_exp2(unit_test_sqrt(error)) - 1;
+
+        if (rms < result->rms * UNIT_TEST_COMPLEXITY_PREFERENCE)
+        {
+            result->fit = model;
+            result->coefficient = unit_test_exp2(intercept);
+            result->rms = rms;
+        }
+    }
+}
+
+/**
+ * A private utility function that records the wall and CPU time of a phase of a test case,
+ * which began at the given times, and then advances the given times to the present.
+ */
+static void unit_test_time_phase (unit_test_phase_time_t* phase, int64_t* wall_ns, int64_t* cpu_ns)
+{
+    int64_t now_wall_ns = unit_test_monotonic();
+    int64_t now_cpu_ns = unit_test_thread_cpu();
+
+    phase->wall_ns = now_wall_ns - *wall_ns;
+    phase->cpu_ns = now_cpu_ns - *cpu_ns;
+    *wall_ns = now_wall_ns;
+    *cpu_ns = now_cpu_ns;
+}
+
+/**
+ * A private utility function used to obtain the name of a signal,
+ * which terminated the process that was executing a test case.
+ */
+static const char* unit_test_signal_name (int32_t signal)
+{
+    switch (signal)
+    {
+        case SIGABRT: return "SIGABRT";
+        case SIGALRM: return "SIGALRM";
+        case SIGBUS: return "SIGBUS";
+        case SIGFPE: return "SIGFPE";
+        case SIGILL: return "SIGILL";
+        case SIGINT: return "SIGINT";
+        case SIGKILL: return "SIGKILL";
+        case SIGPIPE: return "SIGPIPE";
+        case SIGQUIT: return "SIGQUIT";
+        case SIGSEGV: return "SIGSEGV";
+        case SIGSYS: return "SIGSYS";
+        case SIGTERM: return "SIGTERM";
+        case SIGTRAP: return "SIGTRAP";
+        case SIGXCPU: return "SIGXCPU";
+        case SIGXFSZ: return "SIGXFSZ";
+        default: return "unknown signal";
+    }
+}
+
+/**
+ * The allocations made during the current phase (setup, body, or teardown) of the test case,
+ * which is currently being executed. The counters are only updated while tracking is on.
+ */
+static unit_test_allocations_t unit_test_phase_allocations;
+
+/**
+ * True, while a phase of a test case is being executed,
+ * such that allocations are counted.
+ */
+static bool unit_test_tracking;
+
+/**
+ * True, if the per test case resource usage (allocations, file descriptors,
+ * and maximum resident set size) shall be reported, and the allocations counted.
+ */
+static bool unit_test_track_resources;
+
+/**
+ * True, if the allocations of the test case that is executing are counted, which is the case given --track-resources,
+ * or once an allocation assertion requested it, whereupon the test case is executed again.
+ */
+static bool unit_test_counting;
+static bool unit_test_counting_requested;
+
+const unit_test_allocations_t* unit_test_get_allocations ()
+{
+    return &unit_test_phase_allocations;
+}
+
+const unit_test_allocations_t* unit_test_check_allocations (const char* file, int32_t line)
+{
+#if defined(__GLIBC__) && defined(UNIT_TEST_INTERPOSE)
+    if (unit_test_counting == false && unit_test_failure != NULL)
+    {
+        // Request that the test case is executed again, while counting, and stop it, if this is the thread of the runner.
+        // Otherwise, the assertion is vacuous on this thread, but the test case is executed again nonetheless.
+        __atomic_store_n(&unit_test_counting_requested, true, __ATOMIC_RELAXED);
+
+        if (unit_test_runner_thread)
+        {
+            longjmp(unit_test_jump_point, 1);
+        }
+    }
+#else
+    unit_test_fail(file, line, true, "Allocation tracking is inactive, since unit_test.c was not compiled with UNIT_TEST_INTERPOSE and glibc.");
+#endif
+
+    return &unit_test_phase_allocations;
+}
+
+#if defined(__GLIBC__) && defined(UNIT_TEST_INTERPOSE)
+
+#include <malloc.h>
+
+/**
+ * A block that was allocated by the current test case, and is still allocated.
+ */
+typedef struct
+{
+    /**
+     * The address of the block, or NULL, if the slot is empty.
+     */
+    void* pointer;
+
+    /**
+     * The usable size of the block.
+     */
+    int64_t size;
+
+    /**
+     * The phase of the test case, in which the block was allocated.
+     */
+    int32_t phase;
+
+} unit_test_block_t;
+
+/**
+ * This is the open-addressed hash table of the blocks that were allocated by the current test case,
+ * and are still allocated, whose size is a power of two, or zero, and the number of blocks therein.
+ * The table is allocated from the real allocator, so that it is not counted against the test case.
+ */
+static unit_test_block_t* unit_test_blocks;
+static size_t unit_test_block_capacity;
+static size_t unit_test_block_count;
+
+/**
+ * This is the number of the current phase of the test case, which tags the blocks allocated therein.
+ */
+static int32_t unit_test_phase_number;
+
+/**
+ * A spin lock, which serializes the updates of the table of blocks by the threads of concurrent test cases.
+ */
+static int32_t unit_test_block_lock;
+
+/**
+ * A private function that obtains the slot of the table of blocks, where the given block is, or would be.
+ */
+static size_t unit_test_find_block (void* pointer)
+{
+    size_t mask = unit_test_block_capacity - 1;
+    size_t slot = (size_t) (((uintptr_t) pointer >> 4) * 0x9E3779B97F4A7C15ULL) & mask;
+
+    while (unit_test_blocks[slot].pointer != NULL && unit_test_blocks[slot].pointer != pointer)
+    {
+        slot = (slot + 1) & mask;
+    }
+
+    return slot;
+}
+
+/**
+ * A private function that adds a block to the table of blocks, which is doubled, once it is half full.
+ * If the table cannot grow, then the block is not added, and is thus not reported as leaked.
+ */
+static void unit_test_add_block (void* pointer, int64_t size)
+{
+    if (unit_test_block_count + 1 > unit_test_block_capacity / 2)
+    {
+        size_t capacity = unit_test_block_capacity > 0 ? 2 * unit_test_block_capacity : 1024;
+        unit_test_block_t* old = unit_test_blocks;
+        size_t old_capacity = unit_test_block_capacity;
+        unit_test_block_t* blocks = __libc_calloc(capacity, sizeof(unit_test_block_t));
+
+        if (blocks == NULL)
+        {
+            return;
+        }
+
+        unit_test_blocks = blocks;
+        unit_test_block_capacity = capacity;
+
+        for (size_t k = 0; k < old_capacity; k++)
+        {
+            if (old[k].pointer != NULL)
+            {
+                unit_test_blocks[unit_test_find_block(old[k].pointer)] = old[k];
+            }
+        }
+
+        __libc_free(old);
+    }
+
+    size_t slot = unit_test_find_block(pointer);
+    unit_test_blocks[slot].pointer = pointer;
+    unit_test_blocks[slot].size = size;
+    unit_test_blocks[slot].phase = unit_test_phase_number;
+    ++unit_test_block_count;
+}
+
+/**
+ * A private function that removes a block from the table of blocks, if it is therein,
+ * by shifting the following blocks of the run back, so that no tombstones are needed.
+ * The return value is the block, whose pointer is NULL, if it was not therein.
+ */
+static unit_test_block_t unit_test_remove_block (void* pointer)
+{
+    unit_test_block_t removed = { NULL, 0, 0 };
+
+    if (unit_test_block_capacity == 0)
+    {
+        return removed;
+    }
+
+    size_t mask = unit_test_block_capacity - 1;
+    size_t hole = unit_test_find_block(pointer);
+
+    if (unit_test_blocks[hole].pointer == NULL)
+    {
+        return removed;
+    }
+
+    removed = unit_test_blocks[hole];
+    --unit_test_block_count;
+
+    for (size_t slot = (hole + 1) & mask; unit_test_blocks[slot].pointer != NULL; slot = (slot + 1) & mask)
+    {
+        size_t home = (size_t) (((uintptr_t) unit_test_blocks[slot].pointer >> 4) * 0x9E3779B97F4A7C15ULL) & mask;
+
+        // Move the block into the hole, unless its home lies cyclically after the hole, up to the slot.
+        if (((slot - home) & mask) >= ((slot - hole) & mask))
+        {
+            unit_test_blocks[hole] = unit_test_blocks[slot];
+            hole = slot;
+        }
+    }
+
+    unit_test_blocks[hole].pointer = NULL;
+    return removed;
+}
+
+/**
+ * A private function that acquires the lock of the table of blocks.
+ */
+static void unit_test_lock_blocks ()
+{
+    while (__atomic_exchange_n(&unit_test_block_lock, 1, __ATOMIC_ACQUIRE))
+    {
+        sched_yield();
+    }
+}
+
+/**
+ * A private function that releases the lock of the table of blocks.
+ */
+static void unit_test_unlock_blocks ()
+{
+    __atomic_store_n(&unit_test_block_lock, 0, __ATOMIC_RELEASE);
+}
+
+/**
+ * A private function that releases the table of blocks at exit.
+ */
+static void unit_test_release_blocks ()
+{
+    __libc_free(unit_test_blocks);
+    unit_test_blocks = NULL;
+    unit_test_block_capacity = 0;
+    unit_test_block_count = 0;
+}
+
+/**
+ * A private function that counts an allocation, if tracking is on.
+ * The live bytes are measured in terms of the usable size of the block,
+ * so that the same size is subtracted, when the block is freed.
+ */
+static void unit_test_count_allocation (void* pointer, size_t requested)
+{
+    if (pointer != NULL && __atomic_load_n(&unit_test_tracking, __ATOMIC_RELAXED))
+    {
+        unit_test_allocations_t* counters = &unit_test_phase_allocations;
+        int64_t size = (int64_t) malloc_usable_size(pointer);
+        int64_t live = __atomic_add_fetch(&counters->live_bytes, size, __ATOMIC_RELAXED);
+        int64_t peak = __atomic_load_n(&counters->peak_live_bytes, __ATOMIC_RELAXED);
+
+        __atomic_add_fetch(&counters->allocations, 1, __ATOMIC_RELAXED);
+        __atomic_add_fetch(&counters->allocated_bytes, requested, __ATOMIC_RELAXED);
+
+        while (live > peak && !__atomic_compare_exchange_n(&counters->peak_live_bytes, &peak, live, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+        {
+            // Pass. Retry with the updated peak.
+        }
+
+        unit_test_lock_blocks();
+        unit_test_add_block(pointer, size);
+        counters->leaked_bytes += size;
+        unit_test_unlock_blocks();
+    }
+}
+
+/**
+ * A private function that counts a deallocation of a block of the given usable size,
+ * which is no longer leaked, if it was allocated during the current phase.
+ * The caller holds the lock of the table of blocks.
+ */
+static void unit_test_forget_block (void* pointer, int64_t size)
+{
+    __atomic_add_fetch(&unit_test_phase_allocations.frees, 1, __ATOMIC_RELAXED);
+    __atomic_sub_fetch(&unit_test_phase_allocations.live_bytes, size, __ATOMIC_RELAXED);
+
+    unit_test_block_t block = unit_test_remove_block(pointer);
+
+    if (block.pointer != NULL && block.phase == unit_test_phase_number)
+    {
+        unit_test_phase_allocations.leaked_bytes -= block.size;
+    }
+}
+
+/**
+ * A private function that counts a deallocation of a block, if tracking is on.
+ * The tracking flag is checked first, so that a free outside of a test case costs no more than a load.
+ */
+static void unit_test_count_free (void* pointer)
+{
+    if (pointer != NULL && __atomic_load_n(&unit_test_tracking, __ATOMIC_RELAXED))
+    {
+        int64_t size = (int64_t) malloc_usable_size(pointer);
+        unit_test_lock_blocks();
+        unit_test_forget_block(pointer, size);
+        unit_test_unlock_blocks();
+    }
+}
+
+void* malloc (size_t size)
+{
+    void* pointer = __libc_malloc(size);
+    unit_test_count_allocation(pointer, size);
+    return pointer;
+}
+
+void* calloc (size_t count, size_t size)
+{
+    void* pointer = __libc_calloc(count, size);
+    unit_test_count_allocation(pointer, count * size);
+    return pointer;
+}
+
+void* realloc (void* pointer, size_t size)
+{
+    if (__atomic_load_n(&unit_test_tracking, __ATOMIC_RELAXED) == false)
+    {
+        return __libc_realloc(pointer, size);
+    }
+
+    // The lock is held across the reallocation, so that no other thread records the old address, once it is freed,
+    // before it is forgotten here. If the reallocation fails, then the original block remains allocated, and is not counted.
+    int64_t old_size = pointer != NULL ? (int64_t) malloc_usable_size(pointer) : 0;
+
+    unit_test_lock_blocks();
+    void* result = __libc_realloc(pointer, size);
+
+    if (pointer != NULL && (result != NULL || size == 0))
+    {
+        unit_test_forget_block(pointer, old_size);
+    }
+
+    unit_test_unlock_blocks();
+    unit_test_count_allocation(result, size);
+    return result;
+}
+
+void free (void* pointer)
+{
+    unit_test_count_free(pointer);
+    __libc_free(pointer);
+}
+
+void* memalign (size_t alignment, size_t size)
+{
+    void* pointer = __libc_memalign(alignment, size);
+    unit_test_count_allocation(pointer, size);
+    return pointer;
+}
+
+void* aligned_alloc (size_t alignment, size_t size)
+{
+    return memalign(alignment, size);
+}
+
+int posix_memalign (void** result, size_t alignment, size_t size)
+{
+    if (alignment < sizeof(void*) || (alignment & (alignment - 1)) != 0)
+    {
+        return EINVAL;
+    }
+
+    void* pointer = memalign(alignment, size);
+
+    if (pointer == NULL)
+    {
+        return ENOMEM;
+    }
+
+    *result = pointer;
+    return 0;
+}
+
+#endif
+
+/**
+ * A private function that starts counting the allocations of a phase of a test case, if they are counted.
+ * The first phase (the setup) forgets the blocks that the previous test case leaked.
+ */
+static void unit_test_begin_phase (bool first)
+{
+#if defined(__GLIBC__) && defined(UNIT_TEST_INTERPOSE)
+    static bool registered = false;
+
+    if (unit_test_counting == false)
+    {
+        return;
+    }
+
+    if (registered == false)
+    {
+        registered = atexit(unit_test_release_blocks) == 0;
+    }
+
+    if (first && unit_test_block_count > 0)
+    {
+        memset(unit_test_blocks, 0, unit_test_block_capacity * sizeof(unit_test_block_t));
+        unit_test_block_count = 0;
+    }
+
+    ++unit_test_phase_number;
+    memset(&unit_test_phase_allocations, 0, sizeof(unit_test_allocations_t));
+    __atomic_store_n(&unit_test_tracking, true, __ATOMIC_RELAXED);
+#endif
+}
+
+/**
+ * A private function that pauses the counting of allocations, while the harness itself allocates on behalf of a test case,
+ * such as while starting and joining threads. The return value is whether they were being counted, to resume with.
+ */
+static bool unit_test_pause_tracking ()
+{
+    return __atomic_exchange_n(&unit_test_tracking, false, __ATOMIC_RELAXED);
+}
+
+/**
+ * A private function that resumes the counting of allocations, if they were being counted, when paused.
+ */
+static void unit_test_resume_tracking (bool tracking)
+{
+    __atomic_store_n(&unit_test_tracking, tracking, __ATOMIC_RELAXED);
+}
+
+/**
+ * A private function that stops counting the allocations of a phase of a test case,
+ * and adds the allocations thereof to the totals of the test case.
+ */
+static void unit_test_end_phase (unit_test_allocations_t* totals)
+{
+#if defined(__GLIBC__) && defined(UNIT_TEST_INTERPOSE)
+    if (unit_test_counting == false)
+    {
+        return;
+    }
+
+    __atomic_store_n(&unit_test_tracking, false, __ATOMIC_RELAXED);
+
+    unit_test_allocations_t* phase = &unit_test_phase_allocations;
+    int64_t peak = totals->live_bytes + phase->peak_live_bytes;
+    int64_t leaked = 0;
+
+    // The blocks still in the table are those, which the test case allocated during any phase so far, and has not freed.
+    for (size_t k = 0; k < unit_test_block_capacity; k++)
+    {
+        leaked += unit_test_blocks[k].pointer != NULL ? unit_test_blocks[k].size : 0;
+    }
+
+    totals->allocations += phase->allocations;
+    totals->frees += phase->frees;
+    totals->allocated_bytes += phase->allocated_bytes;
+    totals->peak_live_bytes = peak > totals->peak_live_bytes ? peak : totals->peak_live_bytes;
+    totals->live_bytes += phase->live_bytes;
+    totals->leaked_bytes = leaked;
+#endif
+}
+
+/**
+ * A chunk of the arena, which is followed by the allocations therein.
+ */
+typedef struct unit_test_chunk_s
+{
+    /**
+     * The next chunk, if any, which is used, once this one is full.
+     */
+    struct unit_test_chunk_s* next;
+
+    /**
+     * The size of the chunk, including this header.
+     */
+    size_t size;
+
+    /**
+     * The number of bytes of the chunk that are in use, including this header.
+     */
+    size_t used;
+
+} unit_test_chunk_t;
+
+/**
+ * A position in the arena, to which the arena can be reset.
+ */
+typedef struct
+{
+    /**
+     * The chunk that was being allocated from, or NULL, if nothing had been allocated yet.
+     */
+    unit_test_chunk_t* chunk;
+
+    /**
+     * The number of bytes of the chunk that were in use.
+     */
+    size_t used;
+
+} unit_test_arena_mark_t;
+
+// The size of the header of a chunk, such that the allocations therein are aligned.
+#define UNIT_TEST_ARENA_HEADER_SIZE ((sizeof(unit_test_chunk_t) + UNIT_TEST_ARENA_ALIGNMENT - 1) & ~((size_t) UNIT_TEST_ARENA_ALIGNMENT - 1))
+
+/**
+ * These are the chunks of the arena, which are kept for reuse, once the arena is reset,
+ * and the chunk that is currently being allocated from, which is NULL, until the first allocation.
+ */
+static unit_test_chunk_t* unit_test_arena_first;
+static unit_test_chunk_t* unit_test_arena_chunk;
+
+/**
+ * A spin lock, which serializes the allocations of the threads of concurrent test cases.
+ */
+static int32_t unit_test_arena_lock;
+
+/**
+ * True, if the allocations of the arena shall be overwritten, when it is reset, given --poison-arena.
+ */
+static bool unit_test_poison_arena;
+
+/**
+ * A private function that maps a chunk, which can hold an allocation of the given size, and which precedes the given chunk.
+ * The pages of the chunk are faulted in at once, rather than while the test cases execute.
+ */
+static unit_test_chunk_t* unit_test_map_chunk (size_t size, unit_test_chunk_t* next)
+{
+    size_t page = (size_t) sysconf(_SC_PAGESIZE);
+    size_t length = size > UNIT_TEST_ARENA_CHUNK_SIZE - UNIT_TEST_ARENA_HEADER_SIZE ? size + UNIT_TEST_ARENA_HEADER_SIZE : UNIT_TEST_ARENA_CHUNK_SIZE;
+    length = (length + page - 1) & ~(page - 1);
+
+    void* memory = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0);
+
+    if (memory == MAP_FAILED)
+    {
+        return NULL;
+    }
+
+    unit_test_chunk_t* chunk = (unit_test_chunk_t*) memory;
+    chunk->next = next;
+    chunk->size = length;
+    chunk->used = UNIT_TEST_ARENA_HEADER_SIZE;
+    return chunk;
+}
+
+void* unit_test_alloc (size_t size)
+{
+    // Even an empty allocation gets a distinct address.
+    size = size == 0 ? UNIT_TEST_ARENA_ALIGNMENT : (size + UNIT_TEST_ARENA_ALIGNMENT - 1) & ~((size_t) UNIT_TEST_ARENA_ALIGNMENT - 1);
+
+    if (size == 0 || size > SIZE_MAX / 2)
+    {
+        return NULL; // The size overflowed, when it was aligned.
+    }
+
+    while (__atomic_exchange_n(&unit_test_arena_lock, 1, __ATOMIC_ACQUIRE))
+    {
+        sched_yield();
+    }
+
+    unit_test_chunk_t* chunk = unit_test_arena_chunk;
+
+    // Move on to the next chunk, if this one is full, unless the next one is too small, or there is none,
+    // in which case a new chunk is mapped in front thereof.
+    if (chunk == NULL || chunk->size - chunk->used < size)
+    {
+        unit_test_chunk_t* next = chunk != NULL ? chunk->next : unit_test_arena_first;
+
+        if (next == NULL || next->size - UNIT_TEST_ARENA_HEADER_SIZE < size)
+        {
+            next = unit_test_map_chunk(size, next);
+
+            if (next != NULL && chunk != NULL)
+            {
+                chunk->next = next;
+            }
+            else if (next != NULL)
+            {
+                unit_test_arena_first = next;
+            }
+        }
+
+        if (next == NULL)
+        {
+            __atomic_store_n(&unit_test_arena_lock, 0, __ATOMIC_RELEASE);
+            return NULL;
+        }
+
+        next->used = UNIT_TEST_ARENA_HEADER_SIZE;
+        chunk = next;
+        unit_test_arena_chunk = chunk;
+    }
+
+    void* pointer = (uint8_t*) chunk + chunk->used;
+    chunk->used += size;
+
+    __atomic_store_n(&unit_test_arena_lock, 0, __ATOMIC_RELEASE);
+    return pointer;
+}
+
+void* unit_test_calloc (size_t count, size_t size)
+{
+    if (size != 0 && count > SIZE_MAX / size)
+    {
+        return NULL;
+    }
+
+    // The chunks are not zeroed, when reused, so the memory is zeroed here.
+    void* pointer = unit_test_alloc(count * size);
+    return pointer != NULL ? memset(pointer, 0, count * size) : NULL;
+}
+
+void* unit_test_memdup (const void* buffer, size_t size)
+{
+    void* pointer = unit_test_alloc(size);
+    return pointer != NULL ? memcpy(pointer, buffer, size) : NULL;
+}
+
+char* unit_test_strdup (const char* text)
+{
+    return unit_test_memdup(text, strlen(text) + 1);
+}
+
+/**
+ * A private function that obtains the current position in the arena.
+ */
+static unit_test_arena_mark_t unit_test_mark_arena ()
+{
+    unit_test_arena_mark_t mark;
+    mark.chunk = unit_test_arena_chunk;
+    mark.used = mark.chunk != NULL ? mark.chunk->used : 0;
+    return mark;
+}
+
+/**
+ * A private function that releases everything allocated from the arena since the given position,
+ * in constant time, since the chunks that were filled since are simply reused, when the arena refills.
+ * Given --poison-arena, the released allocations are overwritten, so that using them after the teardown
+ * is likely to fail loudly, which takes time proportional to the size thereof.
+ */
+static void unit_test_reset_arena (unit_test_arena_mark_t mark)
+{
+    unit_test_chunk_t* last = unit_test_arena_chunk;
+
+    for (unit_test_chunk_t* chunk = mark.chunk != NULL ? mark.chunk : unit_test_arena_first; unit_test_poison_arena && chunk != NULL; chunk = chunk->next)
+    {
+        size_t start = chunk == mark.chunk ? mark.used : UNIT_TEST_ARENA_HEADER_SIZE;
+        memset((uint8_t*) chunk + start, UNIT_TEST_ARENA_POISON, chunk->used - start);
+
+        if (chunk == last)
+        {
+            break;
+        }
+    }
+
+    unit_test_arena_chunk = mark.chunk != NULL ? mark.chunk : unit_test_arena_first;
+
+    if (unit_test_arena_chunk != NULL)
+    {
+        unit_test_arena_chunk->used = mark.chunk != NULL ? mark.used : UNIT_TEST_ARENA_HEADER_SIZE;
+    }
+}
+
+/**
+ * A private function that counts the open file descriptors of this process.
+ */
+static int32_t unit_test_count_descriptors ()
+{
+    int32_t count = 0;
+    DIR* directory = opendir("/proc/self/fd");
+
+    if (directory != NULL)
+    {
+        for (struct dirent* entry = readdir(directory); entry != NULL; entry = readdir(directory))
+        {
+            count += entry->d_name[0] != '.' ? 1 : 0;
+        }
+
+        closedir(directory);
+        return count - 1; // Exclude the descriptor of the directory itself.
+    }
+
+    for (int fd = 0; fd < 4096; fd++)
+    {
+        count += fcntl(fd, F_GETFD) != -1 ? 1 : 0;
+    }
+
+    return count;
+}
+
+/**
+ * True, if hardware performance counters shall be measured around the body of each test case.
+ */
+static bool unit_test_perf_enabled;
+
+#ifdef __linux__
+
+/**
+ * The events in the group of performance counters, in the order that they are read.
+ * The first event is the leader of the group.
+ */
+static const uint64_t unit_test_perf_events[] =
+{
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES,
+    PERF_COUNT_HW_BRANCH_MISSES
+};
+
+#define UNIT_TEST_PERF_EVENT_COUNT ((int) (sizeof(unit_test_perf_events) / sizeof(unit_test_perf_events[0])))
+
+/**
+ * The file descriptors of the performance counters, or -1.
+ * If the hardware counters are unavailable (virtual machine, perf_event_paranoid, etc),
+ * then the first descriptor is the task-clock software counter and the rest are -1.
+ */
+static int unit_test_perf_fds[UNIT_TEST_PERF_EVENT_COUNT] = { -1, -1, -1, -1 };
+
+/**
+ * True, if the counters are hardware counters, rather than the software fallback.
+ */
+static bool unit_test_perf_hardware;
+
+/**
+ * The process that opened the counters, since counters only measure the thread that opened them;
+ * therefore, forked workers and isolated children must open counters of their own.
+ */
+static pid_t unit_test_perf_owner;
+
+/**
+ * A private function that opens a performance counter for the calling thread.
+ */
+static int unit_test_perf_open (uint32_t type, uint64_t config, int group)
+{
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = group < 0 ? 1 : 0;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP;
+
+    return (int) syscall(SYS_perf_event_open, &attr, 0, -1, group, 0);
+}
+
+/**
+ * A private function that closes the performance counters, if any.
+ */
+static void unit_test_perf_close ()
+{
+    for (int k = 0; k < UNIT_TEST_PERF_EVENT_COUNT; k++)
+    {
+        if (unit_test_perf_fds[k] >= 0)
+        {
+            close(unit_test_perf_fds[k]);
+        }
+
+        unit_test_perf_fds[k] = -1;
+    }
+}
+
+/**
+ * A private function that opens the group of performance counters, if not already open
+ * in this process, and falls back to the task-clock software counter, if need be.
+ * The return value is false, if not even the software counter is available.
+ */
+static bool unit_test_perf_prepare ()
+{
+    if (unit_test_perf_owner == getpid())
+    {
+        return unit_test_perf_fds[0] >= 0;
+    }
+
+    // Any descriptors were inherited from the parent and measure the parent, not us.
+    unit_test_perf_close();
+    unit_test_perf_owner = getpid();
+    unit_test_perf_hardware = true;
+
+    for (int k = 0; k < UNIT_TEST_PERF_EVENT_COUNT && unit_test_perf_hardware; k++)
+    {
+        unit_test_perf_fds[k] = unit_test_perf_open(PERF_TYPE_HARDWARE, unit_test_perf_events[k], k == 0 ? -1 : unit_test_perf_fds[0]);
+        unit_test_perf_hardware = unit_test_perf_fds[k] >= 0;
+    }
+
+    if (unit_test_perf_hardware == false)
+    {
+        unit_test_perf_close();
+        unit_test_perf_owner = getpid();
+        unit_test_perf_fds[0] = unit_test_perf_open(PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK, -1);
+    }
+
+    return unit_test_perf_fds[0] >= 0;
+}
+
+/**
+ * A private function that resets and starts the performance counters.
+ */
+static void unit_test_perf_start ()
+{
+    if (unit_test_perf_enabled && unit_test_perf_prepare())
+    {
+        ioctl(unit_test_perf_fds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(unit_test_perf_fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+}
+
+/**
+ * A private function that stops the performance counters and reads them into the given result.
+ */
+static void unit_test_perf_stop (unit_test_perf_counters_t* counters)
+{
+    uint64_t values[1 + UNIT_TEST_PERF_EVENT_COUNT];
+
+    if (unit_test_perf_enabled == false || unit_test_perf_fds[0] < 0 || unit_test_perf_owner != getpid())
+    {
+        return;
+    }
+
+    ioctl(unit_test_perf_fds[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+    // With PERF_FORMAT_GROUP, the number of events precedes the values thereof.
+    if (read(unit_test_perf_fds[0], values, sizeof(values)) < (ssize_t) (2 * sizeof(uint64_t)))
+    {
+        return;
+    }
+
+    counters->valid = true;
+    counters->hardware = unit_test_perf_hardware;
+
+    if (unit_test_perf_hardware && values[0] == UNIT_TEST_PERF_EVENT_COUNT)
+    {
+        counters->cycles = values[1];
+        counters->instructions = values[2];
+        counters->cache_misses = values[3];
+        counters->branch_misses = values[4];
+    }
+    else
+    {
+        counters->task_clock_ns = values[1];
+    }
+}
+
+#else
+
+static bool unit_test_perf_prepare ()
+{
+    return false; // Performance counters are only supported on Linux.
+}
+
+static void unit_test_perf_start ()
+{
+    // Pass. Performance counters are only supported on Linux.
+}
+
+static void unit_test_perf_stop (unit_test_perf_counters_t* counters)
+{
+    // Pass. Performance counters are only supported on Linux.
+}
+
+#endif
+
+/**
+ * A private utility function used to sort samples in ascending order.
+ */
+static int unit_test_compare_double (const void* left, const void* right)
+{
+    double x = *(const double*) left;
+    double y = *(const double*) right;
+    return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+/**
+ * A private utility function that obtains a percentile of sorted samples.
+ */
+static double unit_test_percentile (const double* sorted, uint32_t count, double percentile)
+{
+    double exact = percentile * count;
+    uint32_t rank = (uint32_t) exact;
+    rank += ((double) rank < exact) ? 1 : 0;
+    return sorted[rank == 0 ? 0 : rank - 1];
+}
+
+/**
+ * A private function that invokes an operation the given number of times
+ * and returns the elapsed monotonic time thereof, in nanoseconds.
+ */
+static int64_t unit_test_time_batch (unit_test_function_t operation, uint64_t batch)
+{
+    int64_t start = unit_test_monotonic();
+
+    for (uint64_t k = 0; k < batch; k++)
+    {
+        operation();
+    }
+
+    return unit_test_monotonic() - start;
+}
+
+/**
+ * A private function that benchmarks an operation within the time budget.
+ *
+ * First, the operation is warmed up, for a tenth of the budget, while the
+ * batch size is scaled up until a batch takes long enough that the overhead
+ * of reading the clock is negligible. Then, batches are timed, until either
+ * the budget is exhausted or the maximum number of samples is collected.
+ */
+static void unit_test_benchmark (unit_test_function_t operation, unit_test_bench_result_t* result)
+{
+    double samples[UNIT_BENCH_MAX_SAMPLES];
+    double deviations[UNIT_BENCH_MAX_SAMPLES];
+    int64_t target_ns = unit_test_bench_time_ns / UNIT_BENCH_MAX_SAMPLES;
+    int64_t start = unit_test_monotonic();
+    uint64_t batch = 1;
+
+    target_ns = target_ns < 10000 ? 10000 : target_ns;
+
+    // Warmup and calibrate the batch size.
+    for (;;)
+    {
+        int64_t elapsed = unit_test_time_batch(operation, batch);
+
+        if (elapsed < target_ns)
+        {
+            batch = elapsed < target_ns / 10 ? batch * 10 : batch * 2;
+        }
+        else if (unit_test_monotonic() - start >= unit_test_bench_time_ns / 10)
+        {
+            break;
+        }
+    }
+
+    // Collect the samples, which is all that the performance counters cover.
+    uint32_t count = 0;
+
+    unit_test_perf_start();
+
+    while (count < UNIT_BENCH_MAX_SAMPLES && (count < 10 || unit_test_monotonic() - start < unit_test_bench_time_ns))
+    {
+        samples[count++] = ((double) unit_test_time_batch(operation, batch)) / ((double) batch);
+    }
+
+    qsort(samples, count, sizeof(double), unit_test_compare_double);
+
+    double median = unit_test_percentile(samples, count, 0.5);
+
+    for (uint32_t k = 0; k < count; k++)
+    {
+        deviations[k] = samples[k] > median ? samples[k] - median : median - samples[k];
+    }
+
+    qsort(deviations, count, sizeof(double), unit_test_compare_double);
+
+    result->samples = count;
+    result->batch = batch;
+    result->iterations = batch * count;
+    result->min_ns = samples[0];
+    result->median_ns = median;
+    result->p99_ns = unit_test_percentile(samples, count, 0.99);
+    result->mad_ns = unit_test_percentile(deviations, count, 0.5);
+    result->ops_per_second = median > 0 ? 1e9 / median : 0;
+}
+
+/**
+ * A private function that determines whether a test case failed during the previous run.
+ */
+static bool unit_test_previously_failed (int32_t index)
+{
+    return unit_test_history != NULL && unit_test_history[index].present && unit_test_history[index].passed == false;
+}
+
+/**
+ * A private function that obtains the expected duration of a test case, which is
+ * the duration thereof during a previous execution in this process, if any,
+ * or else as recorded in the state file, if any, or else zero.
+ */
+static int64_t unit_test_expected_duration (int32_t index)
+{
+    int64_t elapsed = unit_test_cases[index].result.elapsed_time_mono_ns;
+
+    if (elapsed == 0 && unit_test_history != NULL && unit_test_history[index].present)
+    {
+        elapsed = unit_test_history[index].elapsed_time_mono_ns;
+    }
+
+    return elapsed;
+}
+
+/**
+ * True, while a test case is reported, which passed, and the output of which was captured and discarded,
+ * whereupon the text reporter reports the test case by a single line, rather than in full.
+ */
+static bool unit_test_condensed;
+
+/**
+ * A private function that prints the banner preceding a test case.
+ */
+static void unit_test_print_case_begin (FILE* output, const unit_test_case_t* test)
+{
+    if (unit_test_condensed)
+    {
+        return;
+    }
+
+    fprintf(output, "----------------------------- TEST CASE -----------------------------\n");
+    fprintf(output, "Suite: %s\n", test->suite);
+    fprintf(output, "Name: %s\n", test->name);
+}
+
+/**
+ * A private function that prints the results of a test case.
+ */
+static void unit_test_print_case_end (FILE* output, const unit_test_case_t* test)
+{
+    const unit_test_case_result_t* result = &test->result;
+    int32_t index = (int32_t) (test - unit_test_cases);
+
+    char wall[32];
+    char cpu[32];
+
+    if (unit_test_condensed)
+    {
+        fprintf(output, "PASS: %s/%s (%s)\n", test->suite, test->name, unit_test_format_time(wall, sizeof(wall), (double) result->elapsed_time_mono_ns));
+        return;
+    }
+
+    fprintf(output, "Elapsed Time: %s (CPU %s)\n",
+           unit_test_format_time(wall, sizeof(wall), (double) result->elapsed_time_mono_ns),
+           unit_test_format_time(cpu, sizeof(cpu), (double) result->cpu_time_ns));
+
+    // Break down the time by phase, if there is more than one phase.
+    if (NULL != unit_test_hot[index].setup || NULL != unit_test_hot[index].teardown)
+    {
+        const char* labels[3] = { "Setup:   ", "Body:    ", "Teardown:" };
+        const unit_test_phase_time_t* phases[3] = { &result->setup_time, &result->body_time, &result->teardown_time };
+
+        for (int k = 0; k < 3; k++)
+        {
+            fprintf(output, "    %s %s (CPU %s)\n",
+                   labels[k],
+                   unit_test_format_time(wall, sizeof(wall), (double) phases[k]->wall_ns),
+                   unit_test_format_time(cpu, sizeof(cpu), (double) phases[k]->cpu_ns));
+        }
+    }
+
+    if (unit_test_hot[index].kind == UNIT_TEST_KIND_BENCH && result->bench.samples > 0)
+    {
+        fprintf(output, "Benchmark: %u samples of %llu operations\n", result->bench.samples, (unsigned long long) result->bench.batch);
+        fprintf(output, "    Min:        %s/op\n", unit_test_format_time(wall, sizeof(wall), result->bench.min_ns));
+        fprintf(output, "    Median:     %s/op\n", unit_test_format_time(wall, sizeof(wall), result->bench.median_ns));
+        fprintf(output, "    P99:        %s/op\n", unit_test_format_time(wall, sizeof(wall), result->bench.p99_ns));
+        fprintf(output, "    MAD:        %s/op\n", unit_test_format_time(wall, sizeof(wall), result->bench.mad_ns));
+        fprintf(output, "    Throughput: %.0f ops/s\n", result->bench.ops_per_second);
+    }
+
+    if (unit_test_hot[index].kind == UNIT_TEST_KIND_TABLE)
+    {
+        fprintf(output, "Rows: %lld (%lld failed)\n", (long long) result->table.rows, (long long) result->table.failed_rows);
+
+        if (result->table.failed_rows > 0)
+        {
+            fprintf(output, "    Rerun the first failed row via: --filter '%s/%s' --rows %lld\n",
+                   test->suite,
+                   test->name,
+                   (long long) result->table.first_failed_row);
+        }
+    }
+
+    if (unit_test_hot[index].kind == UNIT_TEST_KIND_PROPERTY)
+    {
+        fprintf(output, "Property: %llu runs", (unsigned long long) result->property.runs);
+
+        if (result->property.falsified)
+        {
+            fprintf(output, ", %llu shrinks", (unsigned long long) result->property.shrinks);
+        }
+
+        fprintf(output, " (reproduce via: --seed %llu)\n", (unsigned long long) result->property.seed);
+    }
+
+    if (unit_test_hot[index].kind == UNIT_TEST_KIND_CONCURRENT)
+    {
+        const unit_test_concurrent_result_t* concurrent = &result->concurrent;
+
+        fprintf(output, "Concurrent: %d threads, %d rounds (%d failed)\n", concurrent->threads, concurrent->rounds, concurrent->failures);
+        fprintf(output, "    Round:      median %s, ", unit_test_format_time(wall, sizeof(wall), (double) concurrent->round_median_ns));
+        fprintf(output, "max %s\n", unit_test_format_time(wall, sizeof(wall), (double) concurrent->round_max_ns));
+        fprintf(output, "    Thread:     median %s, ", unit_test_format_time(wall, sizeof(wall), (double) concurrent->thread_median_ns));
+        fprintf(output, "max %s\n", unit_test_format_time(wall, sizeof(wall), (double) concurrent->thread_max_ns));
+        fprintf(output, "    Start Skew: median %s, ", unit_test_format_time(wall, sizeof(wall), (double) concurrent->skew_median_ns));
+        fprintf(output, "max %s\n", unit_test_format_time(wall, sizeof(wall), (double) concurrent->skew_max_ns));
+    }
+
+    if (unit_test_hot[index].kind == UNIT_TEST_KIND_COMPLEXITY && result->complexity.sizes > 0)
+    {
+        const unit_test_complexity_result_t* complexity = &result->complexity;
+
+        fprintf(output, "Complexity: %s (RMS %.1f%%)", unit_test_growth_name(complexity->fit), 100.0 * complexity->rms);
+        fprintf(output, complexity->bounded ? ", at most %s\n" : "\n", unit_test_growth_name(complexity->bound));
+
+        for (int32_t k = 0; k < complexity->sizes; k++)
+        {
+            if (complexity->instructions)
+            {
+                fprintf(output, "    n = %lld: %.0f instructions\n", (long long) unit_test_complexity_size(test, k), test->complexity_cost[k]);
+            }
+            else
+            {
+                fprintf(output, "    n = %lld: %s\n", (long long) unit_test_complexity_size(test, k), unit_test_format_time(wall, sizeof(wall), test->complexity_cost[k]));
+            }
+        }
+    }
+
+    if (result->perf.valid && result->perf.hardware)
+    {
+        double instructions = (double) result->perf.instructions;
+        fprintf(output, "Cycles: %llu\n", (unsigned long long) result->perf.cycles);
+        fprintf(output, "Instructions: %llu\n", (unsigned long long) result->perf.instructions);
+        fprintf(output, "IPC: %.2f\n", result->perf.cycles > 0 ? instructions / (double) result->perf.cycles : 0.0);
+        fprintf(output, "Cache Misses: %llu (%.2f per 1000 instructions)\n",
+               (unsigned long long) result->perf.cache_misses,
+               instructions > 0 ? 1000.0 * (double) result->perf.cache_misses / instructions : 0.0);
+        fprintf(output, "Branch Misses: %llu (%.2f per 1000 instructions)\n",
+               (unsigned long long) result->perf.branch_misses,
+               instructions > 0 ? 1000.0 * (double) result->perf.branch_misses / instructions : 0.0);
+    }
+    else if (result->perf.valid)
+    {
+        fprintf(output, "Task Clock: %s (hardware counters unavailable)\n", unit_test_format_time(cpu, sizeof(cpu), (double) result->perf.task_clock_ns));
+    }
+
+    if (unit_test_track_resources)
+    {
+        fprintf(output, "Allocations: %llu (%llu bytes)\n", (unsigned long long) result->allocations.allocations, (unsigned long long) result->allocations.allocated_bytes);
+        fprintf(output, "Frees: %llu\n", (unsigned long long) result->allocations.frees);
+        fprintf(output, "Peak Live Bytes: %lld\n", (long long) result->allocations.peak_live_bytes);
+        fprintf(output, "Leaked Bytes: %lld\n", (long long) result->allocations.leaked_bytes);
+        fprintf(output, "File Descriptors: %+d\n", result->descriptor_delta);
+        fprintf(output, "Max RSS: %lld KB\n", (long long) result->max_rss_kb);
+    }
+
+    if (result->passed)
+    {
+        fprintf(output, "Result: PASS\n");
+    }
+    else if (result->timed_out)
+    {
+        fprintf(output, "Result: FAIL (timeout after %s)\n", unit_test_format_time(wall, sizeof(wall), (double) unit_test_timeout_ns));
+    }
+    else if (result->signal != 0)
+    {
+        fprintf(output, "Result: FAIL (%s)\n", unit_test_signal_name(result->signal));
+    }
+    else
+    {
+        fprintf(output, "Result: FAIL\n");
+    }
+
+    fprintf(output, "--------------------------- END TEST CASE ---------------------------\n");
+    fprintf(output, "\n");
+    fprintf(output, "\n");
+}
+
+/**
+ * A private function that prints the totals of a run of the unit tests.
+ */
+static void unit_test_print_summary (FILE* output, const unit_test_run_summary_t* summary)
+{
+    char duration[32];
+
+    fprintf(output, "-------------------------- RESULTS SUMMARY --------------------------\n");
+    fprintf(output, "Passed Tests: %d\n", summary->passed);
+    fprintf(output, "Failed Tests: %d\n", summary->failed);
+    fprintf(output, "Total  Tests: %d\n", summary->passed + summary->failed);
+    fprintf(output, "Elapsed Time: %s\n", unit_test_format_time(duration, sizeof(duration), (double) summary->elapsed_time_mono_ns));
+    fprintf(output, "CPU     Time: %s\n", unit_test_format_time(duration, sizeof(duration), (double) summary->cpu_time_ns));
+    fprintf(output, "Wall    Time: %s\n", unit_test_format_time(duration, sizeof(duration), (double) summary->wall_time_mono_ns));
+
+    if (summary->jobs > 1 && summary->wall_time_mono_ns > 0)
+    {
+        double speedup = ((double) summary->elapsed_time_mono_ns) / ((double) summary->wall_time_mono_ns);
+        fprintf(output, "Speedup:      %.2fx with %d jobs\n", speedup, summary->jobs);
+    }
+
+    if (summary->succeeded)
+    {
+        fprintf(output, "------------------------------ PASSED -------------------------------\n");
+    }
+    else
+    {
+        fprintf(output, "------------------------------ FAILED -------------------------------\n");
+    }
+}
+
+/**
+ * The default reporter, which prints the human readable reports to the console,
+ * interleaved with the output of the test cases.
+ */
+static const unit_test_reporter_t unit_test_text_reporter = {
+    NULL,
+    unit_test_print_case_begin,
+    unit_test_print_case_end,
+    unit_test_print_summary
+};
+
+/**
+ * The types of the fields of the result of a test case, which the structured reporters write.
+ */
+typedef enum
+{
+    UNIT_TEST_FIELD_BOOL,
+    UNIT_TEST_FIELD_INT32,
+    UNIT_TEST_FIELD_INT64,
+    UNIT_TEST_FIELD_UINT32,
+    UNIT_TEST_FIELD_UINT64,
+    UNIT_TEST_FIELD_DOUBLE,
+    UNIT_TEST_FIELD_GROWTH,
+    UNIT_TEST_FIELD_STRING,
+    UNIT_TEST_FIELD_COMPLEXITY_SIZES,
+    UNIT_TEST_FIELD_COMPLEXITY_COSTS
+
+} unit_test_field_type_t;
+
+/**
+ * A field of the result of a test case, which is named by the path thereof within the result.
+ */
+typedef struct
+{
+    /**
+     * The name of the field, wherein a dot separates the name of a nested structure from that of the member thereof.
+     */
+    const char* name;
+
+    /**
+     * The type of the field.
+     */
+    unit_test_field_type_t type;
+
+    /**
+     * The offset of the field within the result, or if the field is an array, which is kept in the test case,
+     * then the offset of the int32_t length thereof within the result.
+     */
+    size_t offset;
+
+} unit_test_field_t;
+
+#define UNIT_TEST_FIELD(NAME, TYPE) { #NAME, UNIT_TEST_FIELD_##TYPE, offsetof(unit_test_case_result_t, NAME) }
+#define UNIT_TEST_ARRAY_FIELD(NAME, TYPE, LENGTH) { #NAME, UNIT_TEST_FIELD_##TYPE, offsetof(unit_test_case_result_t, LENGTH) }
+
+/**
+ * These are all of the fields of the result of a test case, wherein the members of each nested structure are contiguous.
+ */
+static const unit_test_field_t unit_test_fields[] = {
+    UNIT_TEST_FIELD(passed, BOOL),
+    UNIT_TEST_FIELD(start_time_mono_ns, INT64),
+    UNIT_TEST_FIELD(end_time_mono_ns, INT64),
+    UNIT_TEST_FIELD(elapsed_time_mono_ns, INT64),
+    UNIT_TEST_FIELD(cpu_time_ns, INT64),
+    UNIT_TEST_FIELD(setup_time.wall_ns, INT64),
+    UNIT_TEST_FIELD(setup_time.cpu_ns, INT64),
+    UNIT_TEST_FIELD(body_time.wall_ns, INT64),
+    UNIT_TEST_FIELD(body_time.cpu_ns, INT64),
+    UNIT_TEST_FIELD(teardown_time.wall_ns, INT64),
+    UNIT_TEST_FIELD(teardown_time.cpu_ns, INT64),
+    UNIT_TEST_FIELD(signal, INT32),
+    UNIT_TEST_FIELD(timed_out, BOOL),
+    UNIT_TEST_FIELD(bench.samples, UINT32),
+    UNIT_TEST_FIELD(bench.batch, UINT64),
+    UNIT_TEST_FIELD(bench.iterations, UINT64),
+    UNIT_TEST_FIELD(bench.min_ns, DOUBLE),
+    UNIT_TEST_FIELD(bench.median_ns, DOUBLE),
+    UNIT_TEST_FIELD(bench.p99_ns, DOUBLE),
+    UNIT_TEST_FIELD(bench.mad_ns, DOUBLE),
+    UNIT_TEST_FIELD(bench.ops_per_second, DOUBLE),
+    UNIT_TEST_FIELD(table.rows, INT64),
+    UNIT_TEST_FIELD(table.failed_rows, INT64),
+    UNIT_TEST_FIELD(table.first_failed_row, INT64),
+    UNIT_TEST_FIELD(property.seed, UINT64),
+    UNIT_TEST_FIELD(property.runs, UINT64),
+    UNIT_TEST_FIELD(property.shrinks, UINT64),
+    UNIT_TEST_FIELD(property.falsified, BOOL),
+    UNIT_TEST_FIELD(concurrent.threads, INT32),
+    UNIT_TEST_FIELD(concurrent.rounds, INT32),
+    UNIT_TEST_FIELD(concurrent.failures, INT32),
+    UNIT_TEST_FIELD(concurrent.round_median_ns, INT64),
+    UNIT_TEST_FIELD(concurrent.round_max_ns, INT64),
+    UNIT_TEST_FIELD(concurrent.thread_median_ns, INT64),
+    UNIT_TEST_FIELD(concurrent.thread_max_ns, INT64),
+    UNIT_TEST_FIELD(concurrent.skew_median_ns, INT64),
+    UNIT_TEST_FIELD(concurrent.skew_max_ns, INT64),
+    UNIT_TEST_FIELD(complexity.sizes, INT32),
+    UNIT_TEST_FIELD(complexity.instructions, BOOL),
+    UNIT_TEST_ARRAY_FIELD(complexity.n, COMPLEXITY_SIZES, complexity.sizes),
+    UNIT_TEST_ARRAY_FIELD(complexity.cost, COMPLEXITY_COSTS, complexity.sizes),
+    UNIT_TEST_FIELD(complexity.fit, GROWTH),
+    UNIT_TEST_FIELD(complexity.coefficient, DOUBLE),
+    UNIT_TEST_FIELD(complexity.rms, DOUBLE),
+    UNIT_TEST_FIELD(complexity.bounded, BOOL),
+    UNIT_TEST_FIELD(complexity.bound, GROWTH),
+    UNIT_TEST_FIELD(allocations.allocations, UINT64),
+    UNIT_TEST_FIELD(allocations.frees, UINT64),
+    UNIT_TEST_FIELD(allocations.allocated_bytes, UINT64),
+    UNIT_TEST_FIELD(allocations.live_bytes, INT64),
+    UNIT_TEST_FIELD(allocations.leaked_bytes, INT64),
+    UNIT_TEST_FIELD(allocations.peak_live_bytes, INT64),
+    UNIT_TEST_FIELD(descriptor_delta, INT32),
+    UNIT_TEST_FIELD(max_rss_kb, INT64),
+    UNIT_TEST_FIELD(perf.valid, BOOL),
+    UNIT_TEST_FIELD(perf.hardware, BOOL),
+    UNIT_TEST_FIELD(perf.cycles, UINT64),
+    UNIT_TEST_FIELD(perf.instructions, UINT64),
+    UNIT_TEST_FIELD(perf.cache_misses, UINT64),
+    UNIT_TEST_FIELD(perf.branch_misses, UINT64),
+    UNIT_TEST_FIELD(perf.task_clock_ns, UINT64),
+    UNIT_TEST_FIELD(failure.line, INT32),
+    UNIT_TEST_FIELD(failure.file, STRING),
+    UNIT_TEST_FIELD(failure.message, STRING)
+};
+
+#define UNIT_TEST_FIELD_COUNT ((int) (sizeof(unit_test_fields) / sizeof(unit_test_fields[0])))
+
+/**
+ * A private function that writes a string, which is escaped as a JSON string, or as XML character data.
+ */
+static void unit_test_write_escaped (FILE* output, const char* text, bool json)
+{
+    for (const unsigned char* p = (const unsigned char*) text; *p != '\0'; p++)
+    {
+        if (json && (*p == '"' || *p == '\\'))
+        {
+            putc_unlocked('\\', output);
+            putc_unlocked(*p, output);
+        }
+        else if (json && *p < 0x20)
+        {
+            fprintf(output, "\\u%04x", *p);
+        }
+        else if (json)
+        {
+            putc_unlocked(*p, output);
+        }
+        else if (*p == '&' || *p == '<' || *p == '>' || *p == '"' || *p == '\'')
+        {
+            fputs(*p == '&' ? "&amp;" : *p == '<' ? "&lt;" : *p == '>' ? "&gt;" : *p == '"' ? "&quot;" : "&apos;", output);
+        }
+        else if (*p == '\t' || *p == '\n' || *p == '\r')
+        {
+            fprintf(output, "&#%d;", *p);
+        }
+        else if (*p < 0x20)
+        {
+            putc_unlocked('?', output); // Other control characters are not allowed in XML, even as references.
+        }
+        else
+        {
+            putc_unlocked(*p, output);
+        }
+    }
+}
+
+/**
+ * A private function that writes a number, which is written as null in JSON, if not finite.
+ */
+static void unit_test_write_double (FILE* output, double value, bool json)
+{
+    if (json && (value != value || value - value != 0))
+    {
+        fputs("null", output);
+    }
+    else
+    {
+        fprintf(output, "%.17g", value);
+    }
+}
+
+/**
+ * A private function that writes the value of a field of the result of a test case, as JSON, or as an XML attribute,
+ * wherein an array is a sequence of numbers that are separated by spaces.
+ */
+static void unit_test_write_field (FILE* output, const unit_test_field_t* field, const unit_test_case_t* test, bool json)
+{
+    const char* value = (const char*) &test->result + field->offset;
+    int32_t length = 0;
+
+    switch (field->type)
+    {
+        case UNIT_TEST_FIELD_BOOL:
+            fputs(*(const bool*) value ? "true" : "false", output);
+            break;
+        case UNIT_TEST_FIELD_INT32:
+            fprintf(output, "%d", *(const int32_t*) value);
+            break;
+        case UNIT_TEST_FIELD_INT64:
+            fprintf(output, "%lld", (long long) *(const int64_t*) value);
+            break;
+        case UNIT_TEST_FIELD_UINT32:
+            fprintf(output, "%u", *(const uint32_t*) value);
+            break;
+        case UNIT_TEST_FIELD_UINT64:
+            fprintf(output, "%llu", (unsigned long long) *(const uint64_t*) value);
+            break;
+        case UNIT_TEST_FIELD_DOUBLE:
+            unit_test_write_double(output, *(const double*) value, json);
+            break;
+        case UNIT_TEST_FIELD_GROWTH:
+        case UNIT_TEST_FIELD_STRING:
+            fputs(json ? "\"" : "", output);
+            unit_test_write_escaped(output, field->type == UNIT_TEST_FIELD_STRING ? value : unit_test_growth_name(*(const unit_test_complexity_t*) value), json);
+            fputs(json ? "\"" : "", output);
+            break;
+        case UNIT_TEST_FIELD_COMPLEXITY_SIZES:
+        case UNIT_TEST_FIELD_COMPLEXITY_COSTS:
+            length = *(const int32_t*) value;
+            fputs(json ? "[" : "", output);
+
+            for (int32_t k = 0; k < length; k++)
+            {
+                fputs(k == 0 ? "" : json ? "," : " ", output);
+
+                if (field->type == UNIT_TEST_FIELD_COMPLEXITY_SIZES)
+                {
+                    fprintf(output, "%lld", (long long) unit_test_complexity_size(test, k));
+                }
+                else
+                {
+                    unit_test_write_double(output, test->complexity_cost[k], json);
+                }
+            }
+
+            fputs(json ? "]" : "", output);
+            break;
+    }
+}
+
+/**
+ * A private function that writes the result of a test case as a JSON object,
+ * wherein each nested structure of the result is a nested object.
+ */
+static void unit_test_write_json_result (FILE* output, const unit_test_case_t* test)
+{
+    const char* group = NULL;
+    size_t group_length = 0;
+
+    putc_unlocked('{', output);
+
+    for (int k = 0; k < UNIT_TEST_FIELD_COUNT; k++)
+    {
+        const char* name = unit_test_fields[k].name;
+        const char* dot = strchr(name, '.');
+        bool same = group != NULL && dot != NULL && (size_t) (dot - name) == group_length && 0 == strncmp(name, group, group_length);
+
+        if (group != NULL && same == false)
+        {
+            putc_unlocked('}', output);
+            group = NULL;
+        }
+
+        fputs(k == 0 ? "" : ",", output);
+
+        if (dot != NULL && same == false)
+        {
+            group = name;
+            group_length = (size_t) (dot - name);
+            fprintf(output, "\"%.*s\":{", (int) group_length, name);
+        }
+
+        fprintf(output, "\"%s\":", dot != NULL ? dot + 1 : name);
+        unit_test_write_field(output, &unit_test_fields[k], test, true);
+    }
+
+    fputs(group != NULL ? "}}" : "}", output);
+}
+
+/**
+ * A private function that writes the header of the JSON Lines report.
+ */
+static void unit_test_jsonl_start_run (FILE* output, int32_t count)
+{
+    fprintf(output, "{\"event\":\"start\",\"count\":%d}\n", count);
+}
+
+/**
+ * A private function that writes one line of the JSON Lines report per test case.
+ */
+static void unit_test_jsonl_end_case (FILE* output, const unit_test_case_t* test)
+{
+    fputs("{\"event\":\"case\",\"suite\":\"", output);
+    unit_test_write_escaped(output, test->suite, true);
+    fputs("\",\"name\":\"", output);
+    unit_test_write_escaped(output, test->name, true);
+    fputs("\",\"result\":", output);
+    unit_test_write_json_result(output, test);
+    fputs("}\n", output);
+}
+
+/**
+ * A private function that writes the trailer of the JSON Lines report.
+ */
+static void unit_test_jsonl_end_run (FILE* output, const unit_test_run_summary_t* summary)
+{
+    fprintf(output,
+            "{\"event\":\"end\",\"passed\":%d,\"failed\":%d,\"elapsed_time_mono_ns\":%lld,\"cpu_time_ns\":%lld,\"wall_time_mono_ns\":%lld,\"jobs\":%d}\n",
+            summary->passed,
+            summary->failed,
+            (long long) summary->elapsed_time_mono_ns,
+            (long long) summary->cpu_time_ns,
+            (long long) summary->wall_time_mono_ns,
+            summary->jobs);
+}
+
+/**
+ * The reporter that writes one JSON object per line, as each test case finishes.
+ */
+static const unit_test_reporter_t unit_test_jsonl_reporter = {
+    unit_test_jsonl_start_run,
+    NULL,
+    unit_test_jsonl_end_case,
+    unit_test_jsonl_end_run
+};
+
+/**
+ * A private function that writes the element of a test case in the JUnit XML report,
+ * wherein every field of the result is a property, and a failure element describes the failure, if any.
+ */
+static void unit_test_write_junit_case (FILE* output, const unit_test_case_t* test)
+{
+    const unit_test_case_result_t* result = &test->result;
+
+    fputs("    <testcase classname=\"", output);
+    unit_test_write_escaped(output, test->suite, false);
+    fputs("\" name=\"", output);
+    unit_test_write_escaped(output, test->name, false);
+    fprintf(output, "\" time=\"%.9f\">\n", (double) result->elapsed_time_mono_ns / 1e9);
+    fputs("      <properties>\n", output);
+
+    for (int k = 0; k < UNIT_TEST_FIELD_COUNT; k++)
+    {
+        fprintf(output, "        <property name=\"%s\" value=\"", unit_test_fields[k].name);
+        unit_test_write_field(output, &unit_test_fields[k], test, false);
+        fputs("\"/>\n", output);
+    }
+
+    fputs("      </properties>\n", output);
+
+    if (result->passed == false)
+    {
+        const char* type = result->timed_out ? "timeout" : result->signal != 0 ? "signal" : "assertion";
+        const char* message = result->failure.message;
+        char description[64];
+
+        if (result->timed_out)
+        {
+            message = "The test case exceeded the timeout.";
+        }
+        else if (result->signal != 0)
+        {
+            snprintf(description, sizeof(description), "The test case was terminated by %s.", unit_test_signal_name(result->signal));
+            message = description;
+        }
+        else if (message[0] == '\0')
+        {
+            message = "The test case failed.";
+        }
+
+        fprintf(output, "      <failure type=\"%s\" message=\"", type);
+        unit_test_write_escaped(output, message, false);
+        fputs("\">", output);
+
+        if (result->failure.line != 0)
+        {
+            unit_test_write_escaped(output, result->failure.file, false);
+            fprintf(output, ":%d: ", result->failure.line);
+        }
+
+        unit_test_write_escaped(output, message, false);
+        fputs("</failure>\n", output);
+    }
+
+    fputs("    </testcase>\n", output);
+}
+
+/**
+ * A private function that writes the JUnit XML report, with one element per suite.
+ * The whole report is written at the end of the run, since each suite element begins with the totals thereof.
+ */
+static void unit_test_junit_end_run (FILE* output, const unit_test_run_summary_t* summary)
+{
+    fputs("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n", output);
+    fprintf(output,
+            "<testsuites tests=\"%d\" failures=\"%d\" time=\"%.9f\">\n",
+            summary->passed + summary->failed,
+            summary->failed,
+            (double) summary->wall_time_mono_ns / 1e9);
+
+    for (int32_t i = 0; i < unit_test_count; i++)
+    {
+        // Only the first test case of each suite leads to the elements of the suite.
+        if (unit_test_find_suite(unit_test_cases[i].suite) != i)
+        {
+            continue;
+        }
+
+        int32_t tests = 0;
+        int32_t failures = 0;
+        int64_t elapsed_ns = 0;
+
+        for (int32_t j = i; j >= 0; j = unit_test_suite_index.next[j])
+        {
+            tests += unit_test_hot[j].enabled ? 1 : 0;
+            failures += unit_test_hot[j].enabled && unit_test_cases[j].result.passed == false ? 1 : 0;
+            elapsed_ns += unit_test_hot[j].enabled ? unit_test_cases[j].result.elapsed_time_mono_ns : 0;
+        }
+
+        if (tests == 0)
+        {
+            continue;
+        }
+
+        fputs("  <testsuite name=\"", output);
+        unit_test_write_escaped(output, unit_test_cases[i].suite, false);
+        fprintf(output, "\" tests=\"%d\" failures=\"%d\" time=\"%.9f\">\n", tests, failures, (double) elapsed_ns / 1e9);
+
+        for (int32_t j = i; j >= 0; j = unit_test_suite_index.next[j])
+        {
+            if (unit_test_hot[j].enabled)
+            {
+                unit_test_write_junit_case(output, &unit_test_cases[j]);
+            }
+        }
+
+        fputs("  </testsuite>\n", output);
+    }
+
+    fputs("</testsuites>\n", output);
+}
+
+/**
+ * The reporter that writes a JUnit XML document, as understood by most continuous integration servers.
+ */
+static const unit_test_reporter_t unit_test_junit_reporter = {
+    NULL,
+    NULL,
+    NULL,
+    unit_test_junit_end_run
+};
+
+/**
+ * A reporter, which can be selected by name via --reporter.
+ */
+typedef struct
+{
+    /**
+     * The name of the reporter.
+     */
+    const char* name;
+
+    /**
+     * The callbacks of the reporter.
+     */
+    const unit_test_reporter_t* reporter;
+
+} unit_test_named_reporter_t;
+
+/**
+ * These are the reporters, which can be selected, beginning with the built-in ones.
+ */
+static unit_test_named_reporter_t unit_test_reporters[UNIT_TEST_MAX_REPORTERS] = {
+    { "text", &unit_test_text_reporter },
+    { "junit", &unit_test_junit_reporter },
+    { "jsonl", &unit_test_jsonl_reporter }
+};
+
+static int32_t unit_test_reporter_count = 3;
+
+/**
+ * The reporter selected via --reporter, and the output thereof, while the unit tests run.
+ * The output is fully buffered, via a large buffer, so that the report is written in large blocks,
+ * unless the output is the standard output, which the console report shares with the test cases.
+ */
+static const unit_test_reporter_t* unit_test_reporter;
+static FILE* unit_test_report_output;
+static char* unit_test_report_buffer;
+
+/**
+ * True, if the selected reporter is the one named text, which writes the console report,
+ * interleaved with the output of the test cases, wherefore each test case is reported
+ * by the process that executes it, even if that is a worker process.
+ */
+static bool unit_test_report_console;
+
+/**
+ * True, in a worker process, which leaves the reporting of the results to the process that runs the unit tests,
+ * unless the console report is written.
+ */
+static bool unit_test_in_worker;
+
+/**
+ * A private function used to implement the declaration of reporters.
+ * Declaring a reporter with the name of another reporter, including a built-in one, replaces the other reporter.
+ */
+void unit_test_declare_reporter (const char* name, const unit_test_reporter_t* reporter)
+{
+    int32_t k = 0;
+
+    while (k < unit_test_reporter_count && 0 != strcmp(unit_test_reporters[k].name, name))
+    {
+        ++k;
+    }
+
+    if (k == UNIT_TEST_MAX_REPORTERS)
+    {
+        fprintf(stderr, "Unable to declare the reporter %s, since too many reporters were declared.\n", name);
+        exit(EXIT_FAILURE);
+    }
+
+    unit_test_reporters[k].name = name;
+    unit_test_reporters[k].reporter = reporter;
+    unit_test_reporter_count = k == unit_test_reporter_count ? k + 1 : unit_test_reporter_count;
+}
+
+/**
+ * A private function that finds the named reporter, if any, or NULL.
+ */
+static const unit_test_reporter_t* unit_test_find_reporter (const char* name)
+{
+    for (int32_t k = 0; k < unit_test_reporter_count; k++)
+    {
+        if (0 == strcmp(unit_test_reporters[k].name, name))
+        {
+            return unit_test_reporters[k].reporter;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * A private function that informs the selected reporter, if any, that a test case is starting.
+ */
+static void unit_test_report_start (int32_t index)
+{
+    if (unit_test_reporter != NULL && unit_test_reporter->start_case != NULL && (unit_test_in_worker == false || unit_test_report_console))
+    {
+        unit_test_reporter->start_case(unit_test_report_output, &unit_test_cases[index]);
+    }
+}
+
+/**
+ * A private function that informs the selected reporter, if any, that a test case has finished.
+ */
+static void unit_test_report_end (int32_t index)
+{
+    if (unit_test_reporter != NULL && unit_test_reporter->end_case != NULL && (unit_test_in_worker == false || unit_test_report_console))
+    {
+        unit_test_reporter->end_case(unit_test_report_output, &unit_test_cases[index]);
+    }
+}
+
+/**
+ * A private function that selects the given reporter, and opens the output thereof.
+ * The console report is written to the standard output, interleaved with the output of the test cases,
+ * wherefore the standard output is simply redirected to the file, if any. Any other report is written to the file,
+ * or else to the standard output, in which case the output of the test cases is moved to the standard error,
+ * so that the report can be parsed. The former standard output is saved, if it was replaced, or else -1.
+ * The return value is false, if the file could not be opened.
+ */
+static bool unit_test_open_report (const unit_test_reporter_t* reporter, bool console, const char* path, int* saved_stdout)
+{
+    int fd = path != NULL ? open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644) : dup(STDOUT_FILENO);
+
+    *saved_stdout = -1;
+
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    fflush(stdout);
+
+    if (console)
+    {
+        *saved_stdout = path != NULL ? dup(STDOUT_FILENO) : -1;
+
+        if (*saved_stdout >= 0)
+        {
+            dup2(fd, STDOUT_FILENO);
+        }
+
+        close(fd);
+        unit_test_report_output = stdout;
+    }
+    else
+    {
+        unit_test_report_output = fdopen(fd, "w");
+
+        if (unit_test_report_output == NULL)
+        {
+            close(fd);
+            return false;
+        }
+
+        *saved_stdout = path == NULL ? dup(STDOUT_FILENO) : -1;
+
+        if (*saved_stdout >= 0)
+        {
+            dup2(STDERR_FILENO, STDOUT_FILENO);
+        }
+
+        unit_test_report_buffer = malloc(UNIT_TEST_OUTPUT_BUFFER_SIZE);
+
+        if (unit_test_report_buffer != NULL)
+        {
+            setvbuf(unit_test_report_output, unit_test_report_buffer, _IOFBF, UNIT_TEST_OUTPUT_BUFFER_SIZE);
+        }
+    }
+
+    unit_test_reporter = reporter;
+    unit_test_report_console = console;
+    return true;
+}
+
+/**
+ * A private function that closes the output of the selected reporter, if any,
+ * and restores the former standard output, if it was moved.
+ * The return value is false, if the report could not be written.
+ */
+static bool unit_test_close_report (int saved_stdout)
+{
+    bool written = true;
+
+    if (unit_test_report_output == stdout)
+    {
+        written = 0 == fflush(stdout);
+    }
+    else if (unit_test_report_output != NULL)
+    {
+        written = 0 == fclose(unit_test_report_output);
+        free(unit_test_report_buffer);
+        unit_test_report_buffer = NULL;
+    }
+
+    unit_test_report_output = NULL;
+    unit_test_reporter = NULL;
+    unit_test_report_console = false;
+
+    if (saved_stdout >= 0)
+    {
+        fflush(stdout);
+        dup2(saved_stdout, STDOUT_FILENO);
+        close(saved_stdout);
+    }
+
+    return written;
+}
+
+/**
+ * A private function that invokes the function of a table-driven test case for one row.
+ * The return value is false, if an assertion failed for the row.
+ */
+static bool unit_test_invoke_row (unit_test_row_function_t function, const unit_test_row_t* row)
+{
+    if (setjmp(unit_test_jump_point))
+    {
+        return false; // Return point of an assertion jump.
+    }
+
+    function(row);
+    return true;
+}
+
+/**
+ * A private function that executes one row of a table-driven test case,
+ * provided that the row is within the selected range of rows,
+ * and reports the index and values of the row, if the row fails.
+ */
+static void unit_test_execute_row (unit_test_case_t* test, const unit_test_row_t* row, bool text)
+{
+    unit_test_table_result_t* table = &test->result.table;
+
+    if (row->index < unit_test_first_row || row->index > unit_test_last_row)
+    {
+        return; // skip the rows outside of the selected range
+    }
+
+    // Only the first few failed rows are reported in detail,
+    // so that a broken table does not flood the report.
+    unit_test_quiet_failures = table->failed_rows >= UNIT_TEST_MAX_REPORTED_ROWS;
+
+    ++table->rows;
+
+    if (unit_test_invoke_row(test->row_function, row))
+    {
+        return;
+    }
+
+    if (table->failed_rows++ == 0)
+    {
+        table->first_failed_row = row->index;
+    }
+
+    if (unit_test_quiet_failures)
+    {
+        return;
+    }
+
+    printf("    Row: %lld\n", (long long) row->index);
+
+    if (text)
+    {
+        printf("    Values: %s\n", (const char*) row->data);
+    }
+    else
+    {
+        const unsigned char* bytes = (const unsigned char*) row->data;
+        size_t length = row->size < UNIT_TEST_MAX_REPORTED_ROW_BYTES ? row->size : UNIT_TEST_MAX_REPORTED_ROW_BYTES;
+
+        printf("    Values:");
+
+        for (size_t b = 0; b < length; b++)
+        {
+            printf(" %02x", bytes[b]);
+        }
+
+        printf("%s\n", length < row->size ? " ..." : "");
+    }
+}
+
+/**
+ * A private function that executes the rows of the data file of a table-driven test case.
+ * The file is memory-mapped and split into lines lazily, so that only the pages,
+ * which are currently being executed, need to be resident, regardless of the size of the file.
+ * Blank lines and lines that begin with a '#' are not rows.
+ * The return value is false, if the file could not be read.
+ */
+static bool unit_test_execute_data_file (unit_test_case_t* test)
+{
+    // Resolve a relative path against the directory of the declaring source file, if that names a directory,
+    // and fall back to the path as given, which is then relative to the working directory.
+    const char* slash = test->data_source != NULL ? strrchr(test->data_source, '/') : NULL;
+    char path[4096];
+    int fd = -1;
+
+    if (test->data_path[0] != '/' && slash != NULL)
+    {
+        int length = snprintf(path, sizeof(path), "%.*s/%s", (int) (slash - test->data_source), test->data_source, test->data_path);
+        fd = length > 0 && (size_t) length < sizeof(path) ? open(path, O_RDONLY | O_CLOEXEC) : -1;
+    }
+
+    if (fd < 0)
+    {
+        fd = open(test->data_path, O_RDONLY | O_CLOEXEC);
+    }
+
+    struct stat info;
+
+    if (fd < 0 || fstat(fd, &info) != 0)
+    {
+        printf("Unable to read the data file: %s\n", test->data_path);
+
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+
+        return false;
+    }
+
+    size_t size = (size_t) info.st_size;
+    const char* data = size > 0 ? mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0) : NULL;
+    close(fd);
+
+    if (data == MAP_FAILED)
+    {
+        printf("Unable to map the data file: %s\n", test->data_path);
+        return false;
+    }
+
+    if (data != NULL)
+    {
+        madvise((void*) data, size, MADV_SEQUENTIAL);
+    }
+
+    char line[UNIT_TEST_MAX_ROW_SIZE + 1];
+    const char* end = data + size;
+    int64_t index = 0;
+    bool readable = true;
+
+    for (const char* p = data; p < end && index <= unit_test_last_row; )
+    {
+        const char* newline = memchr(p, '\n', (size_t) (end - p));
+        const char* stop = newline != NULL ? newline : end;
+        size_t length = (size_t) (stop - p);
+
+        if (length > 0 && p[length - 1] == '\r')
+        {
+            --length;
+        }
+
+        if (length > 0 && p[0] != '#')
+        {
+            if (length > UNIT_TEST_MAX_ROW_SIZE)
+            {
+                printf("Row %lld of the data file is longer than %d bytes.\n", (long long) index, UNIT_TEST_MAX_ROW_SIZE);
+                readable = false;
+                break;
+            }
+
+            memcpy(line, p, length);
+            line[length] = '\0';
+
+            unit_test_row_t row = { .index = index++, .data = line, .size = length };
+            unit_test_execute_row(test, &row, true);
+        }
+
+        p = stop + 1;
+    }
+
+    if (data != NULL)
+    {
+        munmap((void*) data, size);
+    }
+
+    return readable;
+}
+
+/**
+ * A private function that executes the body of a table-driven test case,
+ * which invokes the function thereof once per row of the static array or data file.
+ * The return value is false, if any row failed, or if the rows could not be read.
+ */
+static bool unit_test_execute_table (unit_test_case_t* test)
+{
+    unit_test_table_result_t* table = &test->result.table;
+    bool readable = true;
+
+    if (test->data_path != NULL)
+    {
+        readable = unit_test_execute_data_file(test);
+    }
+    else
+    {
+        for (int64_t i = 0; i < test->row_count && i <= unit_test_last_row; i++)
+        {
+            unit_test_row_t row = { .index = i, .data = (const char*) test->table + i * test->row_size, .size = test->row_size };
+            unit_test_execute_row(test, &row, false);
+        }
+    }
+
+    unit_test_quiet_failures = false;
+
+    if (table->failed_rows > UNIT_TEST_MAX_REPORTED_ROWS)
+    {
+        printf("The other %lld failed rows were not reported.\n", (long long) (table->failed_rows - UNIT_TEST_MAX_REPORTED_ROWS));
+    }
+
+    return readable && table->failed_rows == 0;
+}
+
+/**
+ * A private function that advances a pseudo-random generator (SplitMix64),
+ * which is fast enough that generating the inputs of cheap properties does not dominate.
+ */
+static uint64_t unit_test_random (uint64_t* state)
+{
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/**
+ * A private function that generates a pseudo-random integer in the range [min, max].
+ * Occasionally, the bounds of the range, or zero, are generated instead,
+ * since those are where off-by-one errors tend to hide.
+ */
+static int64_t unit_test_random_range (uint64_t* state, int64_t min, int64_t max)
+{
+    uint64_t r = unit_test_random(state);
+    uint64_t span = (uint64_t) max - (uint64_t) min;
+
+    if ((r & 7) == 0)
+    {
+        uint64_t pick = (r >> 3) % 3;
+        return pick == 0 ? min : (pick == 1 ? max : (min > 0 ? min : (max < 0 ? max : 0)));
+    }
+
+    r = unit_test_random(state);
+    return span == UINT64_MAX ? (int64_t) r : (int64_t) ((uint64_t) min + r % (span + 1));
+}
+
+/**
+ * A private function that generates an input of a property into the given buffer.
+ */
+static void unit_test_generate (const unit_test_generator_t* generator, unit_test_value_t* value, uint8_t* buffer, uint64_t* state)
+{
+    if (generator->kind == UNIT_TEST_GENERATOR_INTEGER)
+    {
+        value->integer = unit_test_random_range(state, generator->min, generator->max);
+        value->bytes = NULL;
+        value->length = 0;
+        return;
+    }
+
+    size_t length = (size_t) unit_test_random_range(state, generator->min, generator->max);
+
+    // Fill the buffer eight bytes at a time.
+    for (size_t i = 0; i < length; i += 8)
+    {
+        uint64_t r = unit_test_random(state);
+
+        for (size_t k = i; k < i + 8 && k < length; k++, r >>= 8)
+        {
+            buffer[k] = generator->kind == UNIT_TEST_GENERATOR_STRING ? (uint8_t) (' ' + (r & 0xFF) % 95) : (uint8_t) r;
+        }
+    }
+
+    buffer[length] = '\0';
+    value->integer = 0;
+    value->bytes = buffer;
+    value->length = length;
+}
+
+/**
+ * A private function that runs a property once with the given inputs.
+ * The return value is false, if an assertion in the property failed.
+ */
+static bool unit_test_invoke_property (unit_test_property_function_t function, const unit_test_value_t* values)
+{
+    if (setjmp(unit_test_jump_point))
+    {
+        return false; // Return point of an assertion jump.
+    }
+
+    function(values);
+    return true;
+}
+
+/**
+ * The state of the shrinking of the counterexample of a property.
+ */
+typedef struct
+{
+    /**
+     * This is the property being shrunk.
+     */
+    unit_test_case_t* test;
+
+    /**
+     * This is the smallest counterexample found so far, which is stored in unit_test_counterexample.
+     */
+    unit_test_value_t best[UNIT_TEST_MAX_GENERATORS];
+
+    /**
+     * This is the candidate being tried, whose shrunk input is stored in unit_test_generated.
+     */
+    unit_test_value_t candidate[UNIT_TEST_MAX_GENERATORS];
+
+    /**
+     * This is the number of candidates that were tried.
+     */
+    uint64_t steps;
+
+    /**
+     * This is the number of candidates that still failed, and thus replaced the counterexample.
+     */
+    uint64_t shrinks;
+
+} unit_test_shrinker_t;
+
+/**
+ * A private function that runs the property with the candidate, wherein only the given input was shrunk.
+ * If the property still fails, then the candidate becomes the counterexample and the return value is true.
+ */
+static bool unit_test_try_candidate (unit_test_shrinker_t* shrinker, int32_t g)
+{
+    if (shrinker->steps >= UNIT_TEST_MAX_SHRINK_STEPS)
+    {
+        return false;
+    }
+
+    ++shrinker->steps;
+
+    for (int32_t k = 0; k < shrinker->test->generator_count; k++)
+    {
+        if (k != g)
+        {
+            shrinker->candidate[k] = shrinker->best[k];
+        }
+    }
+
+    if (unit_test_invoke_property(shrinker->test->property_function, shrinker->candidate))
+    {
+        return false;
+    }
+
+    unit_test_value_t* value = &shrinker->candidate[g];
+
+    if (value->bytes != NULL)
+    {
+        memcpy(unit_test_counterexample[g], value->bytes, value->length + 1);
+        value->bytes = unit_test_counterexample[g];
+    }
+
+    shrinker->best[g] = *value;
+    ++shrinker->shrinks;
+    return true;
+}
+
+/**
+ * A private function that shrinks an integer input toward zero, or the bound nearest thereto,
+ * by trying ever smaller steps, starting with the entire distance.
+ */
+static bool unit_test_shrink_integer (unit_test_shrinker_t* shrinker, int32_t g)
+{
+    const unit_test_generator_t* generator = &shrinker->test->generators[g];
+    int64_t target = generator->min > 0 ? generator->min : (generator->max < 0 ? generator->max : 0);
+    bool improved = false;
+
+    for (int shift = 0; shift < 63 && shrinker->best[g].integer != target; )
+    {
+        int64_t step = (shrinker->best[g].integer - target) / ((int64_t) 1 << shift);
+
+        if (step == 0)
+        {
+            break;
+        }
+
+        shrinker->candidate[g] = shrinker->best[g];
+        shrinker->candidate[g].integer -= step;
+
+        if (unit_test_try_candidate(shrinker, g))
+        {
+            improved = true;
+            shift = 0;
+        }
+        else
+        {
+            ++shift;
+        }
+    }
+
+    return improved;
+}
+
+/**
+ * A private function that shrinks a buffer or string input, by first removing ever smaller chunks thereof,
+ * and then moving each remaining byte toward the simplest byte, namely zero, or 'a' in a string.
+ */
+static bool unit_test_shrink_buffer (unit_test_shrinker_t* shrinker, int32_t g)
+{
+    const unit_test_generator_t* generator = &shrinker->test->generators[g];
+    unit_test_value_t* best = &shrinker->best[g];
+    unit_test_value_t* candidate = &shrinker->candidate[g];
+    uint8_t* buffer = unit_test_generated[g];
+    bool improved = false;
+
+    for (size_t chunk = best->length - (size_t) generator->min; chunk > 0; chunk /= 2)
+    {
+        for (size_t start = 0; start + chunk <= best->length && best->length - chunk >= (size_t) generator->min; )
+        {
+            memcpy(buffer, best->bytes, start);
+            memcpy(buffer + start, best->bytes + start + chunk, best->length - start - chunk);
+            buffer[best->length - chunk] = '\0';
+            *candidate = (unit_test_value_t) { .integer = 0, .bytes = buffer, .length = best->length - chunk };
+
+            if (unit_test_try_candidate(shrinker, g))
+            {
+                improved = true; // Retry at the same position, which now holds the next chunk.
+            }
+            else
+            {
+                start += chunk;
+            }
+        }
+    }
+
+    int simplest = generator->kind == UNIT_TEST_GENERATOR_STRING ? 'a' : 0;
+
+    for (size_t i = 0; i < best->length; i++)
+    {
+        for (int shift = 0; shift < 8 && best->bytes[i] != simplest; )
+        {
+            int step = (best->bytes[i] - simplest) / (1 << shift);
+
+            if (step == 0)
+            {
+                break;
+            }
+
+            memcpy(buffer, best->bytes, best->length + 1);
+            buffer[i] = (uint8_t) (best->bytes[i] - step);
+            *candidate = (unit_test_value_t) { .integer = 0, .bytes = buffer, .length = best->length };
+
+            if (unit_test_try_candidate(shrinker, g))
+            {
+                improved = true;
+                shift = 0;
+            }
+            else
+            {
+                ++shift;
+            }
+        }
+    }
+
+    return improved;
+}
+
+/**
+ * A private function that prints the inputs of the counterexample of a property.
+ */
+static void unit_test_print_counterexample (const unit_test_case_t* test, const unit_test_value_t* values)
+{
+    for (int32_t g = 0; g < test->generator_count; g++)
+    {
+        const unit_test_value_t* value = &values[g];
+
+        if (test->generators[g].kind == UNIT_TEST_GENERATOR_INTEGER)
+        {
+            printf("    [%d] = %lld\n", g, (long long) value->integer);
+        }
+        else if (test->generators[g].kind == UNIT_TEST_GENERATOR_STRING)
+        {
+            printf("    [%d] = \"%s\" (%zu bytes)\n", g, (const char*) value->bytes, value->length);
+        }
+        else
+        {
+            size_t length = value->length < UNIT_TEST_MAX_REPORTED_ROW_BYTES ? value->length : UNIT_TEST_MAX_REPORTED_ROW_BYTES;
+
+            printf("    [%d] =", g);
+
+            for (size_t b = 0; b < length; b++)
+            {
+                printf(" %02x", value->bytes[b]);
+            }
+
+            printf("%s (%zu bytes)\n", length < value->length ? " ..." : "", value->length);
+        }
+    }
+}
+
+/**
+ * A private function that executes the body of a property-based test case,
+ * which runs the property with freshly generated inputs, until either the property fails,
+ * the number of runs is reached, or the time budget is exhausted.
+ * If the property fails, then the inputs are shrunk to a minimal counterexample,
+ * which is then run once more, so that the failed assertion thereof is reported.
+ * The inputs are generated into static buffers, so the loop never allocates memory.
+ * The return value is false, if a counterexample was found.
+ */
+static bool unit_test_execute_property (unit_test_case_t* test)
+{
+    unit_test_property_result_t* property = &test->result.property;
+    unit_test_value_t values[UNIT_TEST_MAX_GENERATORS];
+
+    // Derive the state from the name of the test case, so that the inputs
+    // of each property do not depend on which other properties are executed.
+    uint64_t state = unit_test_seed ^ unit_test_hash_case(test->suite, test->name);
+    int64_t deadline = unit_test_monotonic() + unit_test_property_time_ns;
+
+    property->seed = unit_test_seed;
+    unit_test_quiet_failures = true;
+
+    while (property->runs < unit_test_property_runs)
+    {
+        // Only consult the clock every so often, which is relatively expensive.
+        if ((property->runs & 255) == 255 && unit_test_monotonic() >= deadline)
+        {
+            break;
+        }
+
+        for (int32_t g = 0; g < test->generator_count; g++)
+        {
+            unit_test_generate(&test->generators[g], &values[g], unit_test_generated[g], &state);
+        }
+
+        ++property->runs;
+
+        if (unit_test_invoke_property(test->property_function, values) == false)
+        {
+            property->falsified = true;
+            break;
+        }
+    }
+
+    if (property->falsified == false)
+    {
+        unit_test_quiet_failures = false;
+        return true;
+    }
+
+    unit_test_shrinker_t shrinker;
+    memset(&shrinker, 0, sizeof(shrinker));
+    shrinker.test = test;
+
+    for (int32_t g = 0; g < test->generator_count; g++)
+    {
+        shrinker.best[g] = values[g];
+
+        if (values[g].bytes != NULL)
+        {
+            memcpy(unit_test_counterexample[g], values[g].bytes, values[g].length + 1);
+            shrinker.best[g].bytes = unit_test_counterexample[g];
+        }
+    }
+
+    for (bool improved = true; improved; )
+    {
+        improved = false;
+
+        for (int32_t g = 0; g < test->generator_count; g++)
+        {
+            if (test->generators[g].kind == UNIT_TEST_GENERATOR_INTEGER)
+            {
+                improved |= unit_test_shrink_integer(&shrinker, g);
+            }
+            else
+            {
+                improved |= unit_test_shrink_buffer(&shrinker, g);
+            }
+        }
+    }
+
+    property->shrinks = shrinker.shrinks;
+
+    // Run the counterexample once more, in order to report the failed assertion.
+    unit_test_quiet_failures = false;
+
+    if (unit_test_invoke_property(test->property_function, shrinker.best))
+    {
+        printf("The counterexample did not fail again, so the property is not deterministic.\n");
+    }
+
+    printf("Counterexample:\n");
+    unit_test_print_counterexample(test, shrinker.best);
+    return false;
+}
+
+/**
+ * The state shared by the threads of a concurrent test case.
+ */
+typedef struct
+{
+    /**
+     * This is the concurrent test case being executed.
+     */
+    unit_test_case_t* test;
+
+    /**
+     * This is the number of threads that were actually started.
+     */
+    int32_t threads;
+
+    /**
+     * This is the zero-based index of the current round.
+     */
+    int32_t round;
+
+    /**
+     * True, once the threads shall exit, rather than execute another round.
+     */
+    bool stop;
+
+    /**
+     * True, once the barriers are initialized, so that the threads may proceed.
+     */
+    bool ready;
+
+    /**
+     * The threads wait until the barriers are ready, since the barriers can only be
+     * initialized once the number of threads, which were actually started, is known.
+     */
+    pthread_mutex_t lock;
+    pthread_cond_t wakeup;
+
+    /**
+     * The threads (and the coordinating thread) wait on these barriers at the start and end of each round,
+     * so that all of the threads start to execute the function at once.
+     */
+    pthread_barrier_t start;
+    pthread_barrier_t end;
+
+    /**
+     * The number of times that the function failed.
+     */
+    int32_t failures;
+
+    /**
+     * The start and end times of each thread in each round, indexed by round times threads plus thread.
+     */
+    int64_t* starts;
+    int64_t* ends;
+
+} unit_test_stress_t;
+
+/**
+ * The argument of a thread of a concurrent test case.
+ */
+typedef struct
+{
+    unit_test_stress_t* stress;
+    int32_t index;
+
+} unit_test_stress_thread_t;
+
+/**
+ * A private function that invokes the function of a concurrent test case on one thread.
+ * The return value is false, if an assertion failed on the thread.
+ */
+static bool unit_test_invoke_concurrent (unit_test_concurrent_function_t function, int32_t thread)
+{
+    if (setjmp(unit_test_jump_point))
+    {
+        return false; // Return point of an assertion jump.
+    }
+
+    function(thread);
+    return true;
+}
+
+/**
+ * A private function that is the entry point of each thread of a concurrent test case.
+ */
+static void* unit_test_stress_thread (void* argument)
+{
+    unit_test_stress_thread_t* self = (unit_test_stress_thread_t*) argument;
+    unit_test_stress_t* stress = self->stress;
+
+    // This thread has a jump point of its own, so assertions may fail thereon.
+    unit_test_runner_thread = true;
+
+    pthread_mutex_lock(&stress->lock);
+
+    while (stress->ready == false)
+    {
+        pthread_cond_wait(&stress->wakeup, &stress->lock);
+    }
+
+    pthread_mutex_unlock(&stress->lock);
+
+    for (;;)
+    {
+        pthread_barrier_wait(&stress->start);
+
+        if (stress->stop)
+        {
+            break;
+        }
+
+        int64_t slot = (int64_t) stress->round * stress->threads + self->index;
+        stress->starts[slot] = unit_test_monotonic();
+
+        if (unit_test_invoke_concurrent(stress->test->concurrent_function, self->index) == false)
+        {
+            __atomic_add_fetch(&stress->failures, 1, __ATOMIC_RELAXED);
+        }
+
+        stress->ends[slot] = unit_test_monotonic();
+
+        pthread_barrier_wait(&stress->end);
+    }
+
+    return NULL;
+}
+
+/**
+ * A private function used to sort times in ascending order.
+ */
+static int unit_test_compare_int64 (const void* left, const void* right)
+{
+    int64_t x = *(const int64_t*) left;
+    int64_t y = *(const int64_t*) right;
+    return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+/**
+ * A private function that sorts the given times and obtains the median and maximum thereof.
+ */
+static void unit_test_summarize_times (int64_t* times, int64_t count, int64_t* median, int64_t* max)
+{
+    qsort(times, count, sizeof(int64_t), unit_test_compare_int64);
+    *median = count > 0 ? times[count / 2] : 0;
+    *max = count > 0 ? times[count - 1] : 0;
+}
+
+/**
+ * A private function that computes the timings of the rounds of a concurrent test case.
+ */
+static void unit_test_summarize_stress (unit_test_stress_t* stress, unit_test_concurrent_result_t* result, int64_t* scratch)
+{
+    int32_t threads = stress->threads;
+    int64_t samples = (int64_t) result->rounds * threads;
+
+    for (int64_t k = 0; k < samples; k++)
+    {
+        scratch[k] = stress->ends[k] - stress->starts[k];
+    }
+
+    unit_test_summarize_times(scratch, samples, &result->thread_median_ns, &result->thread_max_ns);
+
+    for (int32_t r = 0; r < result->rounds; r++)
+    {
+        const int64_t* starts = stress->starts + (int64_t) r * threads;
+        const int64_t* ends = stress->ends + (int64_t) r * threads;
+        int64_t first_start = INT64_MAX;
+        int64_t last_start = INT64_MIN;
+        int64_t last_end = INT64_MIN;
+
+        for (int32_t t = 0; t < threads; t++)
+        {
+            first_start = starts[t] < first_start ? starts[t] : first_start;
+            last_start = starts[t] > last_start ? starts[t] : last_start;
+            last_end = ends[t] > last_end ? ends[t] : last_end;
+        }
+
+        scratch[r] = last_end - first_start;
+        scratch[result->rounds + r] = last_start - first_start;
+    }
+
+    unit_test_summarize_times(scratch, result->rounds, &result->round_median_ns, &result->round_max_ns);
+    unit_test_summarize_times(scratch + result->rounds, result->rounds, &result->skew_median_ns, &result->skew_max_ns);
+}
+
+/**
+ * A private function that executes the body of a concurrent test case.
+ * The threads are started once, and then, in each round, the threads are released
+ * from a barrier at once, so that the invocations of the function contend with each other.
+ * If the function fails on any thread, then no further rounds are executed.
+ * The return value is false, if the function failed, or the threads could not be started.
+ */
+static bool unit_test_execute_concurrent (unit_test_case_t* test)
+{
+    unit_test_concurrent_result_t* result = &test->result.concurrent;
+    int32_t threads = test->threads;
+    int32_t rounds = unit_test_rounds;
+
+    // The samples are mapped, rather than allocated, so that they are
+    // not counted as heap allocations made by the test case itself.
+    size_t samples = (size_t) threads * (size_t) rounds;
+    size_t size = sizeof(int64_t) * (3 * samples + 2 * (size_t) rounds) + sizeof(pthread_t) * threads + sizeof(unit_test_stress_thread_t) * threads;
+    void* memory = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    if (memory == MAP_FAILED)
+    {
+        printf("Unable to allocate the samples of the concurrent test case.\n");
+        return false;
+    }
+
+    unit_test_stress_t stress;
+    memset(&stress, 0, sizeof(stress));
+    stress.test = test;
+    stress.starts = (int64_t*) memory;
+    stress.ends = stress.starts + samples;
+    pthread_mutex_init(&stress.lock, NULL);
+    pthread_cond_init(&stress.wakeup, NULL);
+
+    int64_t* scratch = stress.ends + samples;
+    pthread_t* handles = (pthread_t*) (scratch + samples + 2 * (size_t) rounds);
+    unit_test_stress_thread_t* arguments = (unit_test_stress_thread_t*) (handles + threads);
+
+    // Likewise, the allocations made by the C library, in order to start and join the threads, are not counted.
+    // The threads only invoke the function between the barriers, while the allocations are counted.
+    bool tracking = unit_test_pause_tracking();
+
+    while (stress.threads < threads)
+    {
+        arguments[stress.threads] = (unit_test_stress_thread_t) { .stress = &stress, .index = stress.threads };
+
+        if (pthread_create(&handles[stress.threads], NULL, unit_test_stress_thread, &arguments[stress.threads]) != 0)
+        {
+            printf("Unable to start thread %d of the concurrent test case.\n", stress.threads);
+            break;
+        }
+
+        ++stress.threads;
+    }
+
+    bool started = stress.threads == threads;
+
+    pthread_barrier_init(&stress.start, NULL, stress.threads + 1);
+    pthread_barrier_init(&stress.end, NULL, stress.threads + 1);
+
+    pthread_mutex_lock(&stress.lock);
+    stress.ready = true;
+    pthread_cond_broadcast(&stress.wakeup);
+    pthread_mutex_unlock(&stress.lock);
+
+    unit_test_resume_tracking(tracking);
+
+    for (int32_t r = 0; started && r < rounds; r++)
+    {
+        stress.round = r;
+        pthread_barrier_wait(&stress.start);
+        pthread_barrier_wait(&stress.end);
+        result->rounds = r + 1;
+
+        if (__atomic_load_n(&stress.failures, __ATOMIC_RELAXED) > 0)
+        {
+            break; // The function already failed, so stop.
+        }
+    }
+
+    tracking = unit_test_pause_tracking();
+    stress.stop = true;
+    pthread_barrier_wait(&stress.start);
+
+    for (int32_t t = 0; t < stress.threads; t++)
+    {
+        pthread_join(handles[t], NULL);
+    }
+
+    // The summary is not counted either, since qsort() may allocate.
+    result->threads = stress.threads;
+    result->failures = stress.failures;
+    unit_test_summarize_stress(&stress, result, scratch);
+    unit_test_resume_tracking(tracking);
+
+    pthread_barrier_destroy(&stress.start);
+    pthread_barrier_destroy(&stress.end);
+    pthread_cond_destroy(&stress.wakeup);
+    pthread_mutex_destroy(&stress.lock);
+    munmap(memory, size);
+
+    return started && result->failures == 0;
+}
+
+/**
+ * A private function that invokes the function of a complexity test case the given number of times.
+ * The return value is false, if an assertion in the function failed.
+ */
+static bool unit_test_invoke_complexity (unit_test_complexity_function_t function, int64_t n, uint64_t calls)
+{
+    if (setjmp(unit_test_jump_point))
+    {
+        return false; // Return point of an assertion jump.
+    }
+
+    for (uint64_t c = 0; c < calls; c++)
+    {
+        function(n);
+    }
+
+    return true;
+}
+
+/**
+ * A private function that measures one sample of a complexity test case, namely the time and cost of a batch of calls.
+ * The return value is false, if an assertion in the function failed.
+ */
+static bool unit_test_sample_complexity (unit_test_case_t* test, int64_t n, uint64_t calls, int64_t* elapsed_ns, double* cost)
+{
+    unit_test_perf_counters_t counters;
+    memset(&counters, 0, sizeof(counters));
+
+    bool instructions = test->result.complexity.instructions;
+    int64_t start = unit_test_monotonic();
+
+    if (instructions)
+    {
+        unit_test_perf_start();
+    }
+
+    bool passed = unit_test_invoke_complexity(test->complexity_function, n, calls);
+
+    if (instructions)
+    {
+        unit_test_perf_stop(&counters);
+    }
+
+    *elapsed_ns = unit_test_monotonic() - start;
+    *cost = (instructions ? (double) counters.instructions : (double) *elapsed_ns) / (double) calls;
+    return passed;
+}
+
+/**
+ * A private function that measures the cost of one call of a complexity test case at the given input size,
+ * which is the fastest of several samples, wherein the calls are batched, until a batch is long enough to time accurately.
+ * The return value is false, if an assertion in the function failed.
+ */
+static bool unit_test_measure_complexity (unit_test_case_t* test, int64_t n, double* best, int64_t* call_ns)
+{
+    uint64_t calls = 1;
+    int64_t elapsed_ns = 0;
+    double cost = 0;
+
+    *best = 1.0 / 0.0;
+
+    for (int k = 0; k < UNIT_TEST_COMPLEXITY_SAMPLES; k++)
+    {
+        if (unit_test_sample_complexity(test, n, calls, &elapsed_ns, &cost) == false)
+        {
+            return false;
+        }
+
+        *best = cost < *best ? cost : *best;
+
+        if (elapsed_ns < UNIT_TEST_COMPLEXITY_MIN_SAMPLE_NS && calls < (1ULL << 40))
+        {
+            calls *= 2;
+            k = -1; // The samples so far were too short to count.
+            *best = 1.0 / 0.0;
+        }
+    }
+
+    *call_ns = elapsed_ns / (int64_t) calls;
+    return true;
+}
+
+/**
+ * A private function that executes the body of a complexity test case,
+ * which measures the cost of the function at geometrically increasing input sizes,
+ * and fits the costs to the growth models. The cost is the number of instructions retired,
+ * if the hardware performance counters are measured, which is far less noisy; otherwise, the time.
+ * The sizes are measured within the time budget of a benchmark, so that an exponential
+ * function does not run forever, provided that at least three sizes were measured.
+ * If the growth is worse than the bound, or the fit is inconclusive, whichever side of the bound it lands on,
+ * then the sizes are measured again, keeping the least cost of each, so that one preempted size
+ * neither fails the test case, nor lets a worse growth pass as a better one.
+ * The return value is false, if an assertion failed, or the growth is worse than the bound, or still inconclusive.
+ */
+static bool unit_test_execute_complexity (unit_test_case_t* test)
+{
+    unit_test_complexity_result_t* result = &test->result.complexity;
+    int64_t deadline = unit_test_monotonic() + unit_test_bench_time_ns;
+    int64_t last_call_ns = 0;
+    double growth = 1;
+
+    result->instructions = unit_test_perf_enabled && unit_test_perf_prepare() && unit_test_perf_hardware;
+    unit_test_complexity_bounded = false;
+
+    for (int64_t n = test->min_n; n <= test->max_n && result->sizes < UNIT_TEST_MAX_COMPLEXITY_SIZES; n *= 2)
+    {
+        // Predict the time of this size from the growth between the previous sizes.
+        int64_t predicted_ns = (int64_t) (last_call_ns * growth) * UNIT_TEST_COMPLEXITY_SAMPLES;
+        predicted_ns = predicted_ns > UNIT_TEST_COMPLEXITY_MIN_SAMPLE_NS * UNIT_TEST_COMPLEXITY_SAMPLES ? predicted_ns : UNIT_TEST_COMPLEXITY_MIN_SAMPLE_NS * UNIT_TEST_COMPLEXITY_SAMPLES;
+
+        if (result->sizes >= 3 && unit_test_monotonic() + predicted_ns > deadline)
+        {
+            break;
+        }
+
+        double best = 0;
+        int64_t call_ns = 0;
+
+        if (unit_test_measure_complexity(test, n, &best, &call_ns) == false)
+        {
+            return false;
+        }
+
+        growth = last_call_ns > 0 && call_ns > last_call_ns ? (double) call_ns / (double) last_call_ns : 1;
+        last_call_ns = call_ns > 0 ? call_ns : 1;
+
+        test->complexity_cost[result->sizes] = best;
+        ++result->sizes;
+
+        if (n > INT64_MAX / 2)
+        {
+            break;
+        }
+    }
+
+    unit_test_fit_complexity(test);
+
+    for (int attempt = 1; unit_test_complexity_bounded && (result->fit > unit_test_complexity_bound || result->rms > UNIT_TEST_COMPLEXITY_MAX_RMS) && attempt < UNIT_TEST_COMPLEXITY_ATTEMPTS; attempt++)
+    {
+        for (int32_t k = 0; k < result->sizes; k++)
+        {
+            double best = 0;
+            int64_t call_ns = 0;
+
+            if (unit_test_measure_complexity(test, unit_test_complexity_size(test, k), &best, &call_ns) == false)
+            {
+                return false;
+            }
+
+            test->complexity_cost[k] = best < test->complexity_cost[k] ? best : test->complexity_cost[k];
+        }
+
+        unit_test_fit_complexity(test);
+    }
+
+    result->bounded = unit_test_complexity_bounded;
+    result->bound = unit_test_complexity_bound;
+
+    if (result->bounded && result->fit > result->bound)
+    {
+        unit_test_report_failure(unit_test_complexity_file,
+                                 unit_test_complexity_line,
+                                 true,
+                                 "The growth %s is worse than %s.",
+                                 unit_test_growth_name(result->fit),
+                                 unit_test_growth_name(result->bound));
+        return false;
+    }
+
+    if (result->bounded && result->rms > UNIT_TEST_COMPLEXITY_MAX_RMS)
+    {
+        unit_test_report_failure(unit_test_complexity_file,
+                                 unit_test_complexity_line,
+                                 true,
+                                 "The growth is inconclusive, since the best fit %s has an RMS of %.1f%%.",
+                                 unit_test_growth_name(result->fit),
+                                 100.0 * result->rms);
+        return false;
+    }
+
+    return true;
+}
+
+#ifdef UNIT_TEST_COVERAGE
+/**
+ * These are the functions of libgcov, which only exist, if the program was linked with --coverage.
+ */
+extern void __gcov_reset (void);
+extern void __gcov_dump (void);
+#endif
+
+/**
+ * A private function that resets the coverage counters, if UNIT_TEST_COVERAGE was defined when compiling,
+ * which must only be done when building with --coverage, since a weak reference would not link libgcov.
+ * The return value is false, if the coverage cannot be collected.
+ */
+static bool unit_test_gcov_reset ()
+{
+#ifdef UNIT_TEST_COVERAGE
+    __gcov_reset();
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**
+ * A private function that writes the coverage counters to the data (.gcda) files, if UNIT_TEST_COVERAGE was defined.
+ */
+static void unit_test_gcov_dump ()
+{
+#ifdef UNIT_TEST_COVERAGE
+    __gcov_dump();
+#endif
+}
+
+/**
+ * This is the file, opened for appending, to which each process that executes test cases
+ * appends the source files and functions covered by each test case, if collecting the coverage, or -1.
+ * Each line is appended by a single write, so that workers and isolated test cases do not interleave.
+ */
+static int unit_test_coverage_fd = -1;
+
+/**
+ * This is a function in a notes (.gcno) file, which gcc writes next to each object file built with --coverage.
+ */
+typedef struct
+{
+    /**
+     * These identify the function in the data (.gcda) files.
+     */
+    uint32_t ident;
+    uint32_t checksum;
+
+    /**
+     * This is the name of the function.
+     */
+    const char* name;
+
+    /**
+     * These are the source files of the function, including the headers of inlined code,
+     * namely a range of the files of the notes.
+     */
+    int32_t first_file;
+    int32_t file_count;
+} unit_test_notes_function_t;
+
+/**
+ * This is a notes (.gcno) file that was read, which is cached, since every test case
+ * covers the functions of the same object files. The strings point into the contents.
+ */
+typedef struct
+{
+    char* data_path;
+    uint8_t* contents;
+    unit_test_notes_function_t* functions;
+    int32_t function_count;
+    const char** files;
+    int32_t file_count;
+} unit_test_notes_t;
+
+static unit_test_notes_t* unit_test_notes;
+static int32_t unit_test_notes_count;
+
+/**
+ * This is a source file and a function therein, which a test case covered.
+ */
+typedef struct
+{
+    const char* file;
+    const char* function;
+} unit_test_coverage_entry_t;
+
+/**
+ * These are the source files and functions covered by the current test case,
+ * and the length of the path of the directory to which the counters were dumped.
+ */
+static unit_test_coverage_entry_t* unit_test_coverage_entries;
+static int32_t unit_test_coverage_count;
+static size_t unit_test_coverage_prefix;
+
+/**
+ * A private function that grows an array, if need be, so that it has room for one more element.
+ * The return value is false, if there is insufficient memory.
+ */
+static bool unit_test_grow (void** array, int32_t count, size_t size)
+{
+    // The capacity is always a power of two, so it need not be stored.
+    if (count > 0 && (count & (count - 1)) != 0)
+    {
+        return true;
+    }
+
+    void* grown = realloc(*array, size * (count == 0 ? 1 : 2 * (size_t) count));
+
+    if (grown == NULL)
+    {
+        return false;
+    }
+
+    *array = grown;
+    return true;
+}
+
+/**
+ * A private function that reads the whole of a file into memory.
+ * The return value is NULL, if the file could not be read.
+ */
+static uint8_t* unit_test_read_file (const char* path, size_t* size)
+{
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    struct stat status;
+
+    if (fd < 0 || fstat(fd, &status) != 0)
+    {
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+
+        return NULL;
+    }
+
+    uint8_t* contents = malloc((size_t) status.st_size + 1);
+    size_t length = 0;
+
+    while (contents != NULL && length < (size_t) status.st_size)
+    {
+        ssize_t count = read(fd, contents + length, (size_t) status.st_size - length);
+
+        if (count <= 0)
+        {
+            break;
+        }
+
+        length += (size_t) count;
+    }
+
+    close(fd);
+
+    if (contents != NULL && length != (size_t) status.st_size)
+    {
+        free(contents);
+        return NULL;
+    }
+
+    *size = length;
+    return contents;
+}
+
+/**
+ * A private function that reads an unaligned little-endian word of a gcov file, or zero past the end thereof.
+ */
+static uint32_t unit_test_read_word (const uint8_t* contents, size_t size, size_t* offset)
+{
+    uint32_t value = 0;
+
+    if (*offset + 4 <= size)
+    {
+        memcpy(&value, contents + *offset, 4);
+    }
+
+    *offset += 4;
+    return value;
+}
+
+/**
+ * A private function that reads a string of a gcov file, which is its length in bytes,
+ * including the terminator, followed by the characters.
+ */
+static const char* unit_test_read_gcov_string (const uint8_t* contents, size_t size, size_t* offset)
+{
+    uint32_t length = unit_test_read_word(contents, size, offset);
+    const char* string = "";
+
+    if (length > 0 && *offset + length <= size && contents[*offset + length - 1] == '\0')
+    {
+        string = (const char*) contents + *offset;
+    }
+
+    *offset += length;
+    return string;
+}
+
+/**
+ * A private function that determines whether a gcov file has the format of GCC 12 or later,
+ * whereof the lengths are measured in bytes, rather than words. The version is encoded
+ * as the characters of the major version divided by ten, plus 'A', the major version modulo ten,
+ * and the minor version, followed by an asterisk.
+ */
+static bool unit_test_gcov_supported (const uint8_t* contents, size_t size, uint32_t magic)
+{
+    size_t offset = 0;
+    uint32_t actual = unit_test_read_word(contents, size, &offset);
+    uint32_t version = unit_test_read_word(contents, size, &offset);
+    int major = ((int) (version >> 24) - 'A') * 10 + ((int) ((version >> 16) & 0xff) - '0');
+    return size >= 16 && actual == magic && major >= 12;
+}
+
+/**
+ * A private function that determines whether two paths refer to the same source file,
+ * where either may be absolute, such as if the build passed absolute paths to the compiler.
+ */
+static bool unit_test_same_file (const char* left, size_t left_length, const char* right, size_t right_length)
+{
+    const char* longer = left_length >= right_length ? left : right;
+    size_t longer_length = left_length >= right_length ? left_length : right_length;
+    const char* shorter = left_length >= right_length ? right : left;
+    size_t shorter_length = left_length >= right_length ? right_length : left_length;
+
+    if (shorter_length == 0 || memcmp(longer + longer_length - shorter_length, shorter, shorter_length) != 0)
+    {
+        return false;
+    }
+
+    return longer_length == shorter_length || longer[longer_length - shorter_length - 1] == '/';
+}
+
+/**
+ * A private function that determines whether a source file is part of this library,
+ * which every test case executes, so the coverage thereof says nothing about the impact of a change.
+ */
+static bool unit_test_is_harness (const char* file, size_t length)
+{
+    char header[] = __FILE__;
+    header[sizeof(header) - 2] = 'h';
+
+    return unit_test_same_file(file, length, __FILE__, sizeof(__FILE__) - 1)
+           || unit_test_same_file(file, length, header, sizeof(header) - 1);
+}
+
+/**
+ * A private function that reads the functions, and the source files thereof, from a notes file.
+ * The return value is false, if the notes could not be read.
+ */
+static bool unit_test_load_notes (unit_test_notes_t* notes, const char* path)
+{
+    size_t size = 0;
+    uint8_t* contents = unit_test_read_file(path, &size);
+
+    if (contents == NULL || unit_test_gcov_supported(contents, size, UNIT_TEST_GCNO_MAGIC) == false)
+    {
+        free(contents);
+        return false;
+    }
+
+    // Skip the magic, version, stamp, checksum, working directory, and whether any blocks were unexecuted.
+    size_t offset = 16;
+    unit_test_read_gcov_string(contents, size, &offset);
+    offset += 4;
+
+    notes->contents = contents;
+    unit_test_notes_function_t* function = NULL;
+
+    while (offset + 8 <= size)
+    {
+        uint32_t tag = unit_test_read_word(contents, size, &offset);
+        uint32_t length = unit_test_read_word(contents, size, &offset);
+        size_t end = offset + length;
+
+        if (end > size)
+        {
+            break;
+        }
+
+        if (tag == UNIT_TEST_GCOV_TAG_FUNCTION && unit_test_grow((void**) &notes->functions, notes->function_count, sizeof(unit_test_notes_function_t)))
+        {
+            function = &notes->functions[notes->function_count++];
+            function->ident = unit_test_read_word(contents, size, &offset);
+            function->checksum = unit_test_read_word(contents, size, &offset);
+            offset += 4; // the checksum of the control flow graph
+            function->name = unit_test_read_gcov_string(contents, size, &offset);
+            offset += 4; // whether the function is artificial
+            function->first_file = notes->file_count;
+            function->file_count = 0;
+
+            const char* source = unit_test_read_gcov_string(contents, size, &offset);
+
+            if (unit_test_grow((void**) &notes->files, notes->file_count, sizeof(const char*)))
+            {
+                notes->files[notes->file_count++] = source;
+                function->file_count = 1;
+            }
+        }
+        else if (tag == UNIT_TEST_GCOV_TAG_LINES && function != NULL)
+        {
+            // The lines of a block are line numbers, interspersed with a zero and the name of a file,
+            // whenever the file changes, such as for code that was inlined from a header.
+            offset += 4;
+
+            while (offset + 4 <= end)
+            {
+                if (unit_test_read_word(contents, size, &offset) != 0)
+                {
+                    continue;
+                }
+
+                const char* file = unit_test_read_gcov_string(contents, size, &offset);
+                bool known = file[0] == '\0';
+
+                for (int32_t k = 0; k < function->file_count && known == false; k++)
+                {
+                    known = 0 == strcmp(file, notes->files[function->first_file + k]);
+                }
+
+                if (known == false && unit_test_grow((void**) &notes->files, notes->file_count, sizeof(const char*)))
+                {
+                    notes->files[notes->file_count++] = file;
+                    ++function->file_count;
+                }
+            }
+        }
+
+        offset = end;
+    }
+
+    return true;
+}
+
+/**
+ * A private function that finds the cached notes of a data file, reading the notes upon first use.
+ * The return value is NULL, if there is insufficient memory.
+ */
+static unit_test_notes_t* unit_test_find_notes (const char* data_path)
+{
+    for (int32_t i = 0; i < unit_test_notes_count; i++)
+    {
+        if (0 == strcmp(data_path, unit_test_notes[i].data_path))
+        {
+            return &unit_test_notes[i];
+        }
+    }
+
+    if (unit_test_grow((void**) &unit_test_notes, unit_test_notes_count, sizeof(unit_test_notes_t)) == false)
+    {
+        return NULL;
+    }
+
+    unit_test_notes_t* notes = &unit_test_notes[unit_test_notes_count++];
+    memset(notes, 0, sizeof(unit_test_notes_t));
+    notes->data_path = strdup(data_path);
+
+    // The notes are next to the data file, which has the same name, except for the extension.
+    size_t length = strlen(data_path);
+    char path[length + 1];
+    memcpy(path, data_path, length + 1);
+    memcpy(path + length - 5, ".gcno", 5);
+
+    if (notes->data_path == NULL || unit_test_load_notes(notes, path) == false)
+    {
+        // The failure is cached too, so that it is only reported once.
+        printf("Unable to read the coverage notes of GCC 12 or later: %s\n", path);
+    }
+
+    return notes;
+}
+
+/**
+ * A private function, which is invoked for each file under the directory to which the counters were dumped,
+ * that records the functions of each data (.gcda) file that were executed, and the source files thereof.
+ */
+static int unit_test_collect_data (const char* path, const struct stat* status, int type, struct FTW* ftw)
+{
+    size_t length = strlen(path);
+
+    if (type != FTW_F || length < unit_test_coverage_prefix + 5 || 0 != strcmp(path + length - 5, ".gcda"))
+    {
+        return 0;
+    }
+
+    size_t size = 0;
+    uint8_t* contents = unit_test_read_file(path, &size);
+    unit_test_notes_t* notes = unit_test_find_notes(path + unit_test_coverage_prefix);
+
+    if (contents == NULL || notes == NULL || unit_test_gcov_supported(contents, size, UNIT_TEST_GCDA_MAGIC) == false)
+    {
+        free(contents);
+        return 0;
+    }
+
+    // Skip the magic, version, stamp, and checksum.
+    size_t offset = 16;
+    int32_t hint = 0;
+    const unit_test_notes_function_t* function = NULL;
+
+    while (offset + 8 <= size)
+    {
+        uint32_t tag = unit_test_read_word(contents, size, &offset);
+        int32_t length = (int32_t) unit_test_read_word(contents, size, &offset);
+
+        // A negative length means that the counters are all zero, and therefore omitted.
+        size_t end = offset + (length > 0 ? (size_t) length : 0);
+
+        if (end > size)
+        {
+            break;
+        }
+
+        if (tag == UNIT_TEST_GCOV_TAG_FUNCTION && length > 0)
+        {
+            uint32_t ident = unit_test_read_word(contents, size, &offset);
+            uint32_t checksum = unit_test_read_word(contents, size, &offset);
+            function = NULL;
+
+            // The functions are usually in the same order as in the notes.
+            for (int32_t k = 0; k < notes->function_count && function == NULL; k++)
+            {
+                const unit_test_notes_function_t* candidate = &notes->functions[(hint + k) % notes->function_count];
+
+                if (candidate->ident == ident && candidate->checksum == checksum)
+                {
+                    function = candidate;
+                    hint = (hint + k + 1) % notes->function_count;
+                }
+            }
+        }
+        else if (tag == UNIT_TEST_GCOV_TAG_ARCS && function != NULL && length > 0)
+        {
+            bool executed = false;
+
+            for (size_t k = offset; k + 8 <= end && executed == false; k += 8)
+            {
+                uint64_t counter = 0;
+                memcpy(&counter, contents + k, 8);
+                executed = counter != 0;
+            }
+
+            // The functions of this library, such as the allocation hooks, whose first declaration is in a system header, are omitted.
+            for (int32_t k = 0; executed && k < function->file_count; k++)
+            {
+                const char* file = notes->files[function->first_file + k];
+                executed = unit_test_is_harness(file, strlen(file)) == false;
+            }
+
+            for (int32_t k = 0; executed && k < function->file_count; k++)
+            {
+                if (unit_test_grow((void**) &unit_test_coverage_entries, unit_test_coverage_count, sizeof(unit_test_coverage_entry_t)))
+                {
+                    unit_test_coverage_entries[unit_test_coverage_count].file = notes->files[function->first_file + k];
+                    unit_test_coverage_entries[unit_test_coverage_count].function = function->name;
+                    ++unit_test_coverage_count;
+                }
+            }
+
+            function = NULL;
+        }
+
+        offset = end;
+    }
+
+    free(contents);
+    return 0;
+}
+
+/**
+ * A private function, which is invoked for each file under a directory, deepest first, that removes the file.
+ */
+static int unit_test_remove_path (const char* path, const struct stat* status, int type, struct FTW* ftw)
+{
+    remove(path);
+    return 0;
+}
+
+/**
+ * A private function that is used to sort the covered functions by source file and name.
+ */
+static int unit_test_compare_coverage (const void* left, const void* right)
+{
+    const unit_test_coverage_entry_t* a = left;
+    const unit_test_coverage_entry_t* b = right;
+    int order = strcmp(a->file, b->file);
+    return order != 0 ? order : strcmp(a->function, b->function);
+}
+
+/**
+ * A private function that dumps the coverage counters, which were reset before the test case started,
+ * and appends the source files and functions that the test case executed to the coverage map.
+ * The counters are dumped into a directory of their own, rather than merged into the data files of the build.
+ */
+static void unit_test_record_coverage (int32_t index)
+{
+    const char* temporary = getenv("TMPDIR");
+    char directory[4096];
+
+    snprintf(directory, sizeof(directory), "%s/unit_test_coverage_XXXXXX", temporary != NULL ? temporary : "/tmp");
+
+    if (mkdtemp(directory) == NULL)
+    {
+        perror("Unable to record the coverage of the test case");
+        return;
+    }
+
+    char* prefix = getenv("GCOV_PREFIX") != NULL ? strdup(getenv("GCOV_PREFIX")) : NULL;
+    char* strip = getenv("GCOV_PREFIX_STRIP") != NULL ? strdup(getenv("GCOV_PREFIX_STRIP")) : NULL;
+
+    setenv("GCOV_PREFIX", directory, 1);
+    setenv("GCOV_PREFIX_STRIP", "0", 1);
+    unit_test_gcov_dump();
+
+    prefix != NULL ? setenv("GCOV_PREFIX", prefix, 1) : unsetenv("GCOV_PREFIX");
+    strip != NULL ? setenv("GCOV_PREFIX_STRIP", strip, 1) : unsetenv("GCOV_PREFIX_STRIP");
+    free(prefix);
+    free(strip);
+
+    unit_test_coverage_count = 0;
+    unit_test_coverage_prefix = strlen(directory);
+    nftw(directory, unit_test_collect_data, 16, FTW_PHYS);
+    nftw(directory, unit_test_remove_path, 16, FTW_DEPTH | FTW_PHYS);
+
+    qsort(unit_test_coverage_entries, unit_test_coverage_count, sizeof(unit_test_coverage_entry_t), unit_test_compare_coverage);
+
+    // The map is compact, since each file is only named once per line: <suite>/<name> <file>:<function>,<function> ...
+    char* line = NULL;
+    size_t length = 0;
+    FILE* stream = open_memstream(&line, &length);
+
+    if (stream == NULL)
+    {
+        return;
+    }
+
+    fprintf(stream, "%s/%s", unit_test_cases[index].suite, unit_test_cases[index].name);
+
+    for (int32_t k = 0; k < unit_test_coverage_count; k++)
+    {
+        const unit_test_coverage_entry_t* entry = &unit_test_coverage_entries[k];
+        const unit_test_coverage_entry_t* previous = k > 0 ? entry - 1 : NULL;
+
+        if (previous == NULL || 0 != strcmp(previous->file, entry->file))
+        {
+            fprintf(stream, " %s:%s", entry->file, entry->function);
+        }
+        else if (0 != strcmp(previous->function, entry->function))
+        {
+            fprintf(stream, ",%s", entry->function);
+        }
+    }
+
+    fprintf(stream, "\n");
+
+    if (fclose(stream) == 0 && write(unit_test_coverage_fd, line, length) != (ssize_t) length)
+    {
+        perror("Unable to record the coverage of the test case");
+    }
+
+    free(line);
+}
+
+/**
+ * A span of the trace, such as a phase of a test case, which is recorded once it ends.
+ */
+typedef struct
+{
+    /**
+     * The position of the span in the trace buffer plus one, which is stored last,
+     * so that a span, which is only partially written, or was overwritten since, can be told apart.
+     */
+    uint64_t sequence;
+
+    /**
+     * The kind of the span, namely "case", "setup", "body", "teardown", "fixture", or "scope".
+     */
+    const char* category;
+
+    /**
+     * The suite of the test case or fixture, if any, and the name of the span.
+     */
+    const char* suite;
+    const char* name;
+
+    /**
+     * Monotonic time of when the span began and ended.
+     */
+    int64_t start_time_mono_ns;
+    int64_t end_time_mono_ns;
+
+    /**
+     * The process and thread, which are the track of the span.
+     */
+    int32_t pid;
+    int32_t tid;
+
+} unit_test_trace_span_t;
+
+/**
+ * The trace buffer, which is a ring of preallocated spans, in an anonymous shared memory mapping,
+ * which is created before any worker or isolated child process is forked, so that all of them record therein.
+ */
+typedef struct
+{
+    /**
+     * The number of spans that were ever recorded, which is atomically incremented, in order to claim a span.
+     */
+    uint64_t head;
+
+    /**
+     * The spans, of which the last UNIT_TEST_TRACE_CAPACITY are kept.
+     */
+    unit_test_trace_span_t spans[UNIT_TEST_TRACE_CAPACITY];
+
+} unit_test_trace_t;
+
+/**
+ * The trace buffer, given --trace; otherwise, NULL.
+ */
+static unit_test_trace_t* unit_test_trace;
+
+/**
+ * The identifiers of this process and thread, which are cached, since obtaining them requires system calls.
+ * The identifier of the thread is zero, until cached, and reset in a forked child, whose only thread gets a new one.
+ */
+static pid_t unit_test_trace_pid;
+static __thread pid_t unit_test_trace_tid;
+
+/**
+ * A private function that forgets the cached identifiers in a forked child process.
+ */
+static void unit_test_trace_forked ()
+{
+    unit_test_trace_pid = getpid();
+    unit_test_trace_tid = 0;
+}
+
+/**
+ * A private function that records a span in the trace buffer, if tracing, which overwrites the oldest span, if the buffer is full.
+ */
+static void unit_test_record_span (const char* category, const char* suite, const char* name, int64_t start_ns, int64_t end_ns)
+{
+    unit_test_trace_t* trace = unit_test_trace;
+
+    if (trace == NULL)
+    {
+        return;
+    }
+
+    if (unit_test_trace_tid == 0)
+    {
+        unit_test_trace_tid = (pid_t) syscall(SYS_gettid);
+    }
+
+    uint64_t position = __atomic_fetch_add(&trace->head, 1, __ATOMIC_RELAXED);
+    unit_test_trace_span_t* span = &trace->spans[position & (UNIT_TEST_TRACE_CAPACITY - 1)];
+
+    __atomic_store_n(&span->sequence, 0, __ATOMIC_RELAXED);
+    span->category = category;
+    span->suite = suite;
+    span->name = name;
+    span->start_time_mono_ns = start_ns;
+    span->end_time_mono_ns = end_ns;
+    span->pid = unit_test_trace_pid;
+    span->tid = unit_test_trace_tid;
+    __atomic_store_n(&span->sequence, position + 1, __ATOMIC_RELEASE);
+}
+
+unit_test_trace_scope_t unit_test_begin_trace_scope (const char* name)
+{
+    unit_test_trace_scope_t scope;
+    scope.name = name;
+    scope.start_time_mono_ns = unit_test_trace != NULL ? unit_test_monotonic() : -1;
+    return scope;
+}
+
+void unit_test_end_trace_scope (unit_test_trace_scope_t* scope)
+{
+    if (scope->start_time_mono_ns >= 0)
+    {
+        unit_test_record_span("scope", NULL, scope->name, scope->start_time_mono_ns, unit_test_monotonic());
+    }
+}
+
+/**
+ * A private function that creates the trace buffer, whose pages are faulted in at once,
+ * so that recording a span never faults. The return value is false, if it could not be created.
+ */
+static bool unit_test_open_trace ()
+{
+    static bool registered = false;
+
+    void* memory = mmap(NULL, sizeof(unit_test_trace_t), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS | MAP_POPULATE, -1, 0);
+
+    if (memory == MAP_FAILED)
+    {
+        return false;
+    }
+
+    if (registered == false)
+    {
+        pthread_atfork(NULL, NULL, unit_test_trace_forked);
+        registered = true;
+    }
+
+    unit_test_trace_pid = getpid();
+    unit_test_trace_tid = 0;
+    unit_test_trace = (unit_test_trace_t*) memory;
+    return true;
+}
+
+/**
+ * A private function that writes the spans in the trace buffer to a file, in the trace event format
+ * of Chrome, which Perfetto reads too, and then destroys the trace buffer.
+ * Each span is a complete event, on the track of the process and thread that recorded it.
+ * The return value is false, if the file could not be written.
+ */
+static bool unit_test_save_trace (const char* path)
+{
+    unit_test_trace_t* trace = unit_test_trace;
+    uint64_t head = __atomic_load_n(&trace->head, __ATOMIC_ACQUIRE);
+    uint64_t first = head > UNIT_TEST_TRACE_CAPACITY ? head - UNIT_TEST_TRACE_CAPACITY : 0;
+    char* buffer = malloc(UNIT_TEST_OUTPUT_BUFFER_SIZE);
+    FILE* output = fopen(path, "w");
+
+    unit_test_trace = NULL;
+
+    if (output != NULL && buffer != NULL)
+    {
+        setvbuf(output, buffer, _IOFBF, UNIT_TEST_OUTPUT_BUFFER_SIZE);
+    }
+
+    if (output != NULL)
+    {
+        fprintf(output, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+        fprintf(output, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":\"runner\"}}", (int) getpid(), (int) getpid());
+
+        for (uint64_t position = first; position < head; position++)
+        {
+            const unit_test_trace_span_t* span = &trace->spans[position & (UNIT_TEST_TRACE_CAPACITY - 1)];
+
+            if (__atomic_load_n(&span->sequence, __ATOMIC_ACQUIRE) != position + 1)
+            {
+                continue; // The span was never finished, such as by a process that crashed.
+            }
+
+            fputs(",\n{\"name\":\"", output);
+
+            if (0 == strcmp("case", span->category))
+            {
+                unit_test_write_escaped(output, span->suite, true);
+                putc_unlocked('/', output);
+            }
+            else if (0 == strcmp("fixture", span->category))
+            {
+                unit_test_write_escaped(output, span->suite != NULL ? span->suite : "global", true);
+                putc_unlocked(' ', output);
+            }
+
+            unit_test_write_escaped(output, span->name, true);
+            fprintf(output,
+                    "\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%d,\"tid\":%d}",
+                    span->category,
+                    (double) span->start_time_mono_ns / 1000.0,
+                    (double) (span->end_time_mono_ns - span->start_time_mono_ns) / 1000.0,
+                    span->pid,
+                    span->tid);
+        }
+
+        fprintf(output, "\n]}\n");
+    }
+
+    bool saved = output != NULL && 0 == fclose(output);
+
+    if (first > 0)
+    {
+        printf("The trace buffer overflowed, so only the last %d spans were written.\n", UNIT_TEST_TRACE_CAPACITY);
+    }
+
+    free(buffer);
+    munmap(trace, sizeof(unit_test_trace_t));
+    return saved;
+}
+
+/**
+ * A private function that records the span of a test case, which was just executed, and the spans of the phases thereof.
+ */
+static void unit_test_trace_case (int32_t index)
+{
+    const unit_test_case_t* test = &unit_test_cases[index];
+    const unit_test_case_result_t* result = &test->result;
+    int64_t body_start_ns = result->start_time_mono_ns + result->setup_time.wall_ns;
+    int64_t teardown_start_ns = body_start_ns + result->body_time.wall_ns;
+
+    unit_test_record_span("case", test->suite, test->name, result->start_time_mono_ns, result->end_time_mono_ns);
+
+    if (NULL != unit_test_hot[index].setup)
+    {
+        unit_test_record_span("setup", test->suite, "setup", result->start_time_mono_ns, body_start_ns);
+    }
+
+    unit_test_record_span("body", test->suite, "body", body_start_ns, teardown_start_ns);
+
+    if (NULL != unit_test_hot[index].teardown)
+    {
+        unit_test_record_span("teardown", test->suite, "teardown", teardown_start_ns, teardown_start_ns + result->teardown_time.wall_ns);
+    }
+}
+
+/**
+ * A private function that executes a single test case in the current process once,
+ * including its setup and teardown functions, and records the result thereof.
+ */
+static void unit_test_execute_once (int32_t index)
+{
+    unit_test_case_t* test = &unit_test_cases[index];
+    unit_test_case_hot_t* hot = &unit_test_hot[index];
+
+    unit_test_current = index;
+
+    test->result.passed = true;
+    test->result.signal = 0;
+    test->result.timed_out = false;
+    memset(&test->result.bench, 0, sizeof(unit_test_bench_result_t));
+    memset(&test->result.table, 0, sizeof(unit_test_table_result_t));
+    test->result.table.first_failed_row = -1;
+    memset(&test->result.property, 0, sizeof(unit_test_property_result_t));
+    memset(&test->result.concurrent, 0, sizeof(unit_test_concurrent_result_t));
+    memset(&test->result.complexity, 0, sizeof(unit_test_complexity_result_t));
+    memset(&test->result.allocations, 0, sizeof(unit_test_allocations_t));
+    memset(&test->result.perf, 0, sizeof(unit_test_perf_counters_t));
+    test->result.end_time_mono_ns = 0;
+    test->result.elapsed_time_mono_ns = 0;
+    test->result.cpu_time_ns = 0;
+    memset(&test->result.setup_time, 0, sizeof(unit_test_phase_time_t));
+    memset(&test->result.body_time, 0, sizeof(unit_test_phase_time_t));
+    memset(&test->result.teardown_time, 0, sizeof(unit_test_phase_time_t));
+    memset(&test->result.failure, 0, sizeof(unit_test_failure_t));
+    unit_test_failure = &test->result.failure;
+
+#if !defined(__GLIBC__) || !defined(UNIT_TEST_INTERPOSE)
+    // Without the clock hooks, a virtual-time test case would sleep in real time, so it fails at once instead.
+    if (hot->virtual_time)
+    {
+        snprintf(test->result.failure.message,
+                 sizeof(test->result.failure.message),
+                 "Virtual time requires glibc, and unit_test.c to be compiled with UNIT_TEST_INTERPOSE.");
+        printf("%s\n", test->result.failure.message);
+        test->result.passed = false;
+        unit_test_failure = NULL;
+        return;
+    }
+#endif
+
+    // The threads that this test case starts are tagged with its generation, so that their failures are counted against it alone.
+    unit_test_begin_generation();
+
+    // Only attribute the coverage of this test case to it, including that of the setup and teardown thereof.
+    if (unit_test_coverage_fd >= 0)
+    {
+        unit_test_gcov_reset();
+    }
+
+    // Open the performance counters, if need be, before counting the file descriptors.
+    if (unit_test_perf_enabled)
+    {
+        unit_test_perf_prepare();
+    }
+
+    int32_t descriptors = unit_test_track_resources ? unit_test_count_descriptors() : 0;
+
+    // Whatever the test case allocates from the arena is released after the teardown thereof.
+    unit_test_arena_mark_t arena = unit_test_mark_arena();
+
+    // The clocks read the virtual time from the setup through the teardown, while the timings below stay real.
+    if (hot->virtual_time)
+    {
+        unit_test_start_virtual_clock();
+    }
+
+    test->result.start_time_mono_ns = unit_test_monotonic();
+
+    int64_t wall_ns = test->result.start_time_mono_ns;
+    int64_t cpu_ns = unit_test_thread_cpu();
+    int64_t start_cpu_ns = cpu_ns;
+
+    // Execute the setup function, if any,
+    // which may contain assertions too.
+    unit_test_begin_phase(true);
+
+    if (setjmp(unit_test_jump_point))
+    {
+        // Pass. Return point of an assertion jump.
+        test->result.passed = false;
+    }
+    else if (NULL != hot->setup)
+    {
+        hot->setup();
+    }
+
+    unit_test_end_phase(&test->result.allocations);
+    unit_test_time_phase(&test->result.setup_time, &wall_ns, &cpu_ns);
+
+    // If the setup function was successful,
+    // then execute the unit-test case itself.
+    if (test->result.passed)
+    {
+        unit_test_begin_phase(false);
+        unit_test_perf_start();
+
+        if (setjmp(unit_test_jump_point))
+        {
+            // Pass. Return point of an assertion jump.
+            test->result.passed = false;
+        }
+        else if (hot->kind == UNIT_TEST_KIND_BENCH)
+        {
+            unit_test_benchmark(hot->function, &test->result.bench);
+        }
+        else if (hot->kind == UNIT_TEST_KIND_TABLE)
+        {
+            test->result.passed = unit_test_execute_table(test);
+        }
+        else if (hot->kind == UNIT_TEST_KIND_PROPERTY)
+        {
+            test->result.passed = unit_test_execute_property(test);
+        }
+        else if (hot->kind == UNIT_TEST_KIND_CONCURRENT)
+        {
+            test->result.passed = unit_test_execute_concurrent(test);
+        }
+        else if (hot->kind == UNIT_TEST_KIND_COMPLEXITY)
+        {
+            test->result.passed = unit_test_execute_complexity(test);
+        }
+        else
+        {
+            hot->function();
+        }
+
+        unit_test_perf_stop(&test->result.perf);
+        unit_test_end_phase(&test->result.allocations);
+        unit_test_time_phase(&test->result.body_time, &wall_ns, &cpu_ns);
+    }
+
+    // Always execute the teardown function, if any,
+    // which may contain assertions too.
+    unit_test_begin_phase(false);
+
+    if (setjmp(unit_test_jump_point))
+    {
+        // Pass. Return point of an assertion jump.
+        test->result.passed = false;
+    }
+    else if (NULL != hot->teardown)
+    {
+        hot->teardown();
+    }
+
+    unit_test_end_phase(&test->result.allocations);
+    unit_test_time_phase(&test->result.teardown_time, &wall_ns, &cpu_ns);
+    unit_test_reset_arena(arena);
+    unit_test_stop_virtual_clock();
+
+    // Fail the test case, if assertions failed on any threads that it started.
+    int32_t thread_failures = unit_test_end_generation();
+
+    if (thread_failures > 0)
+    {
+        printf("Failed Assertions on Other Threads: %d\n", thread_failures);
+        test->result.passed = false;
+    }
+
+    test->result.end_time_mono_ns = wall_ns;
+    test->result.elapsed_time_mono_ns = test->result.end_time_mono_ns - test->result.start_time_mono_ns;
+    test->result.cpu_time_ns = cpu_ns - start_cpu_ns;
+
+    if (unit_test_track_resources)
+    {
+        struct rusage usage;
+        test->result.descriptor_delta = unit_test_count_descriptors() - descriptors;
+        test->result.max_rss_kb = getrusage(RUSAGE_SELF, &usage) == 0 ? usage.ru_maxrss : 0;
+    }
+
+    if (unit_test_coverage_fd >= 0)
+    {
+        unit_test_record_coverage(index);
+    }
+
+    if (unit_test_trace != NULL)
+    {
+        unit_test_trace_case(index);
+    }
+
+    unit_test_failure = NULL;
+}
+
+/**
+ * A private function that executes a single test case in the current process,
+ * including its setup and teardown functions, and records the result thereof.
+ * If the test case asserted on its allocations, while they were not counted,
+ * then it is executed again, while counting them, so that the assertions are never vacuous.
+ */
+static void unit_test_execute (int32_t index)
+{
+    unit_test_counting = unit_test_track_resources;
+    unit_test_counting_requested = false;
+    unit_test_execute_once(index);
+
+    if (__atomic_load_n(&unit_test_counting_requested, __ATOMIC_RELAXED))
+    {
+        printf("Counting the allocations, which the test case asserts on, and executing it again.\n");
+        unit_test_counting = true;
+        unit_test_execute_once(index);
+    }
+
+    unit_test_counting = false;
+}
+
+/**
+ * A private function that invokes a fixture function, if any, outside of a test case.
+ * The return value is false, if an assertion in the fixture failed.
+ */
+static bool unit_test_try_fixture (unit_test_function_t fixture)
+{
+    if (setjmp(unit_test_jump_point))
+    {
+        return false; // Return point of an assertion jump.
+    }
+    else if (NULL != fixture)
+    {
+        fixture();
+    }
+
+    return true;
+}
+
+/**
+ * A private function that invokes the setup or teardown of a suite, or the global one, if the suite is NULL,
+ * and traces the span thereof, if tracing. The return value is false, if an assertion in the fixture failed.
+ */
+static bool unit_test_invoke_fixture (unit_test_function_t fixture, const char* suite, const char* phase)
+{
+    int64_t start_ns = unit_test_trace != NULL ? unit_test_monotonic() : 0;
+    bool passed = unit_test_try_fixture(fixture);
+
+    if (unit_test_trace != NULL && fixture != NULL)
+    {
+        unit_test_record_span("fixture", suite, phase, start_ns, unit_test_monotonic());
+    }
+
+    return passed;
+}
+
+/**
+ * The result of a test case, which an isolated child process reports to its parent.
+ */
+typedef struct
+{
+    /**
+     * The child process that is executing the test case.
+     */
+    pid_t child;
+
+    /**
+     * True, once the child process has finished the test case,
+     * including the teardown, and stored the result below.
+     */
+    int32_t done;
+
+    /**
+     * The result of the test case, as reported by the child process.
+     */
+    unit_test_case_result_t result;
+
+    /**
+     * If the test case is a complexity test case, then these are the costs thereof, as reported by the child process.
+     */
+    double costs[UNIT_TEST_MAX_COMPLEXITY_SIZES];
+
+} unit_test_report_t;
+
+/**
+ * A private function that obtains the shared memory, through which isolated
+ * child processes report their results. Each process that forks children,
+ * which is either the runner or a worker, gets a mapping of its own.
+ */
+static unit_test_report_t* unit_test_get_report ()
+{
+    static unit_test_report_t* report = NULL;
+    static pid_t owner = 0;
+
+    if (report == NULL || owner != getpid())
+    {
+        void* memory = mmap(NULL, sizeof(unit_test_report_t), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        report = memory == MAP_FAILED ? NULL : (unit_test_report_t*) memory;
+        owner = getpid();
+    }
+
+    return report;
+}
+
+/**
+ * A private function that executes a single test case in a child process,
+ * which is forked from the current process, and records the result thereof.
+ *
+ * Forking reuses the already initialized state of the current process,
+ * which is copy-on-write, so the cost is that of the fork() alone.
+ * If the child crashes, then the test case fails with the name of the signal.
+ * If the child exceeds the timeout, if any, then it is killed and fails.
+ */
+static void unit_test_execute_isolated (int32_t index)
+{
+    unit_test_case_t* test = &unit_test_cases[index];
+    unit_test_report_t* report = unit_test_get_report();
+    int channel[2];
+
+    if (report == NULL || pipe(channel) != 0)
+    {
+        perror("Unable to isolate the test case, so running in-process");
+        unit_test_execute(index);
+        return;
+    }
+
+    report->done = false;
+
+    // Otherwise, buffered output would be printed by both processes.
+    fflush(NULL);
+
+    int64_t start_time_mono_ns = unit_test_monotonic();
+    pid_t pid = fork();
+
+    if (pid == 0)
+    {
+        // The parent detects that the child has finished,
+        // when the write end of the pipe is closed upon exit.
+        close(channel[0]);
+        unit_test_execute(index);
+        report->result = test->result;
+
+        if (test->complexity_cost != NULL)
+        {
+            memcpy(report->costs, test->complexity_cost, sizeof(report->costs));
+        }
+
+        __atomic_store_n(&report->done, true, __ATOMIC_RELEASE);
+        fflush(NULL);
+        _exit(EXIT_SUCCESS);
+    }
+
+    close(channel[1]);
+
+    if (pid < 0)
+    {
+        perror("Unable to isolate the test case, so running in-process");
+        close(channel[0]);
+        unit_test_execute(index);
+        return;
+    }
+
+    report->child = pid;
+
+    bool timed_out = false;
+
+    for (;;)
+    {
+        int wait_ms = -1;
+
+        if (unit_test_timeout_ns > 0)
+        {
+            int64_t remaining_ns = start_time_mono_ns + unit_test_timeout_ns - unit_test_monotonic();
+
+            if (remaining_ns <= 0)
+            {
+                timed_out = true;
+                break;
+            }
+
+            wait_ms = (int) ((remaining_ns + 999999) / 1000000);
+        }
+
+        struct pollfd event = { .fd = channel[0], .events = POLLIN };
+        int ready = poll(&event, 1, wait_ms);
+
+        if (ready < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        else if (ready != 0)
+        {
+            break; // The child exited, or the pipe is unusable.
+        }
+    }
+
+    close(channel[0]);
+
+    if (timed_out)
+    {
+        kill(pid, SIGKILL);
+    }
+
+    int status = 0;
+
+    while (waitpid(pid, &status, 0) < 0 && errno == EINTR)
+    {
+        // Pass. Retry the wait.
+    }
+
+    int64_t end_time_mono_ns = unit_test_monotonic();
+
+    if (__atomic_load_n(&report->done, __ATOMIC_ACQUIRE))
+    {
+        test->result = report->result;
+
+        if (test->complexity_cost != NULL)
+        {
+            memcpy(test->complexity_cost, report->costs, sizeof(report->costs));
+        }
+    }
+    else
+    {
+        test->result.passed = false;
+        test->result.timed_out = timed_out;
+        test->result.signal = !timed_out && WIFSIGNALED(status) ? WTERMSIG(status) : 0;
+        test->result.start_time_mono_ns = start_time_mono_ns;
+        test->result.end_time_mono_ns = end_time_mono_ns;
+        test->result.elapsed_time_mono_ns = end_time_mono_ns - start_time_mono_ns;
+
+        if (!timed_out && WIFEXITED(status))
+        {
+            printf("The test case exited prematurely with status %d.\n", WEXITSTATUS(status));
+        }
+    }
+}
+
+/**
+ * A private function that creates an in-memory file, or else a temporary file, to which output can be redirected.
+ * The return value is -1, if the file could not be created.
+ */
+static int unit_test_create_capture ()
+{
+    int capture = memfd_create("unit_test_capture", MFD_CLOEXEC);
+
+    if (capture < 0)
+    {
+        FILE* file = tmpfile();
+        capture = file != NULL ? dup(fileno(file)) : -1;
+
+        if (file != NULL)
+        {
+            fclose(file);
+        }
+    }
+
+    return capture;
+}
+
+/**
+ * A private function that opens the in-memory file, to which the output of each test case is redirected,
+ * if capturing, upon first use in each process. The return value is -1, if not capturing.
+ */
+static int unit_test_open_capture ()
+{
+    if (unit_test_capture == false || unit_test_capture_owner == getpid())
+    {
+        return unit_test_capture ? unit_test_capture_fd : -1;
+    }
+
+    // A worker inherits the file of its parent, whose offset must not be shared.
+    if (unit_test_capture_fd >= 0)
+    {
+        close(unit_test_capture_fd);
+    }
+
+    unit_test_capture_fd = unit_test_create_capture();
+    unit_test_capture_owner = getpid();
+
+    // Each line that a test case prints must reach the file, so that it can be replayed, even if the test case crashes.
+    fflush(stdout);
+    setvbuf(stdout, NULL, _IOLBF, BUFSIZ);
+
+    return unit_test_capture_fd;
+}
+
+/**
+ * A private function that writes the given bytes to the given file, unless an error occurs.
+ * Only async-signal-safe functions are used, since a signal handler uses this function too.
+ */
+static void unit_test_write_fully (int output, const char* data, size_t size)
+{
+    for (size_t written = 0; written < size; )
+    {
+        ssize_t n = write(output, data + written, size - written);
+
+        if (n < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        else if (n <= 0)
+        {
+            break;
+        }
+
+        written += (size_t) n;
+    }
+}
+
+/**
+ * A private function that copies the output, which was captured in a file, to the given output,
+ * and then empties the file, so that it can capture the output of the next test case.
+ */
+static void unit_test_replay_capture (int capture, int output)
+{
+    char buffer[65536];
+    off_t size = lseek(capture, 0, SEEK_CUR);
+
+    lseek(capture, 0, SEEK_SET);
+
+    while (size > 0)
+    {
+        ssize_t count = read(capture, buffer, sizeof(buffer));
+
+        if (count <= 0)
+        {
+            break;
+        }
+
+        unit_test_write_fully(output, buffer, (size_t) count);
+        size -= count;
+    }
+
+    lseek(capture, 0, SEEK_SET);
+    (void) ftruncate(capture, 0);
+}
+
+/**
+ * A private function that handles a fatal signal, which a test case raised in the runner itself,
+ * while the output thereof was captured, by printing the banner of the test case, and replaying the captured output,
+ * which would otherwise be lost along with the runner. The signal is then raised again,
+ * with the default action restored, so that the runner terminates as it would have.
+ */
+static void unit_test_replay_crash (int signal)
+{
+    static const char message[] = "The test case terminated the runner with ";
+    int output = unit_test_crash_output;
+    const char* name = unit_test_signal_name(signal);
+
+    if (output >= 0 && unit_test_capture_fd >= 0)
+    {
+        unit_test_write_fully(output, unit_test_crash_banner, strlen(unit_test_crash_banner));
+        unit_test_replay_capture(unit_test_capture_fd, output);
+        unit_test_write_fully(output, message, sizeof(message) - 1);
+        unit_test_write_fully(output, name, strlen(name));
+        unit_test_write_fully(output, ".\n", 2);
+    }
+
+    raise(signal);
+}
+
+/**
+ * A private function that arms the fatal signal handlers, which replay the captured output of the given test case,
+ * and saves the former handlers and alternate stack, so that they can be restored afterwards.
+ */
+static void unit_test_arm_crash_replay (int32_t index, int output, struct sigaction* former, stack_t* former_stack)
+{
+    const unit_test_case_t* test = &unit_test_cases[index];
+    const char* rule = "----------------------------- TEST CASE -----------------------------\n";
+
+    if (unit_test_report_console)
+    {
+        snprintf(unit_test_crash_banner, sizeof(unit_test_crash_banner), "%sSuite: %s\nName: %s\n", rule, test->suite, test->name);
+    }
+    else
+    {
+        snprintf(unit_test_crash_banner, sizeof(unit_test_crash_banner), "%s/%s:\n", test->suite, test->name);
+    }
+
+    stack_t stack = { .ss_sp = unit_test_crash_stack, .ss_size = sizeof(unit_test_crash_stack), .ss_flags = 0 };
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = unit_test_replay_crash;
+    action.sa_flags = SA_RESETHAND | SA_ONSTACK;
+    sigemptyset(&action.sa_mask);
+
+    sigaltstack(&stack, former_stack);
+
+    for (size_t k = 0; k < sizeof(unit_test_crash_signals) / sizeof(unit_test_crash_signals[0]); k++)
+    {
+        sigaction(unit_test_crash_signals[k], &action, &former[k]);
+    }
+
+    unit_test_crash_output = output;
+}
+
+/**
+ * A private function that restores the signal handlers and alternate stack,
+ * which were replaced while the test case executed.
+ */
+static void unit_test_disarm_crash_replay (const struct sigaction* former, const stack_t* former_stack)
+{
+    unit_test_crash_output = -1;
+
+    for (size_t k = 0; k < sizeof(unit_test_crash_signals) / sizeof(unit_test_crash_signals[0]); k++)
+    {
+        sigaction(unit_test_crash_signals[k], &former[k], NULL);
+    }
+
+    sigaltstack(former_stack, NULL);
+}
+
+/**
+ * A private function that executes a single test case,
+ * either in-process or isolated, and prints the report thereof.
+ *
+ * When capturing, the output of the setup, body, and teardown, including the failed assertions,
+ * is redirected to an in-memory file, and a passing test case is reported by a single line.
+ * Benchmarks and complexity test cases are always reported in full, since the measurements are the result thereof.
+ */
+static void unit_test_run_case (int32_t index)
+{
+    int capture = unit_test_open_capture();
+    int saved_stdout = capture >= 0 ? dup(STDOUT_FILENO) : -1;
+    int saved_stderr = capture >= 0 ? dup(STDERR_FILENO) : -1;
+    bool captured = saved_stdout >= 0 && saved_stderr >= 0;
+
+    if (captured)
+    {
+        fflush(stdout);
+        fflush(stderr);
+        dup2(capture, STDOUT_FILENO);
+        dup2(capture, STDERR_FILENO);
+    }
+    else
+    {
+        unit_test_report_start(index);
+    }
+
+    // A worker is reported by the parent, if it crashes, and an isolated test case cannot crash the runner.
+    bool replay = captured && unit_test_isolate == false && unit_test_in_worker == false;
+    struct sigaction former[sizeof(unit_test_crash_signals) / sizeof(unit_test_crash_signals[0])];
+    stack_t former_stack;
+
+    if (replay)
+    {
+        unit_test_arm_crash_replay(index, saved_stdout, former, &former_stack);
+    }
+
+    if (unit_test_isolate)
+    {
+        unit_test_execute_isolated(index);
+    }
+    else
+    {
+        unit_test_execute(index);
+    }
+
+    if (replay)
+    {
+        unit_test_disarm_crash_replay(former, &former_stack);
+    }
+
+    if (captured)
+    {
+        fflush(stdout);
+        fflush(stderr);
+        dup2(saved_stdout, STDOUT_FILENO);
+        dup2(saved_stderr, STDERR_FILENO);
+    }
+
+    if (saved_stdout >= 0)
+    {
+        close(saved_stdout);
+    }
+
+    if (saved_stderr >= 0)
+    {
+        close(saved_stderr);
+    }
+
+    unit_test_kind_t kind = unit_test_hot[index].kind;
+    bool measured = kind == UNIT_TEST_KIND_BENCH || kind == UNIT_TEST_KIND_COMPLEXITY;
+
+    if (captured)
+    {
+        unit_test_condensed = unit_test_cases[index].result.passed && unit_test_verbose == false && measured == false;
+        unit_test_report_start(index);
+        fflush(stdout);
+    }
+
+    if (captured && unit_test_condensed)
+    {
+        lseek(capture, 0, SEEK_SET);
+        (void) ftruncate(capture, 0);
+    }
+    else if (captured)
+    {
+        unit_test_replay_capture(capture, STDOUT_FILENO);
+    }
+
+    unit_test_report_end(index);
+    unit_test_condensed = false;
+}
+
+/**
+ * A private function that finds the fixture of the named suite, if any, or NULL.
+ */
+static unit_test_suite_fixture_t* unit_test_find_suite_fixture (const char* suite)
+{
+    for (int32_t k = 0; k < unit_test_suite_fixture_count; k++)
+    {
+        if (0 == strcmp(unit_test_suite_fixtures[k].suite, suite))
+        {
+            return &unit_test_suite_fixtures[k];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * A private function that invokes the setup function of a suite, if any.
+ * If the setup fails, then the fixture remembers the failure, so that
+ * the test cases of the suite can be failed without being executed.
+ */
+static void unit_test_setup_suite (unit_test_suite_fixture_t* fixture)
+{
+    if (fixture != NULL)
+    {
+        fixture->setup_failed = unit_test_invoke_fixture(fixture->setup, fixture->suite, "setup") == false;
+        fixture->active = fixture->setup_failed == false;
+
+        if (fixture->setup_failed)
+        {
+            printf("The setup of suite %s failed, so the test cases thereof were not executed.\n\n", fixture->suite);
+        }
+    }
+}
+
+/**
+ * A private function that invokes the teardown function of a suite, if any,
+ * provided that the setup function thereof succeeded.
+ * The return value is false, if the teardown failed.
+ */
+static bool unit_test_teardown_suite (unit_test_suite_fixture_t* fixture)
+{
+    if (fixture == NULL || fixture->active == false)
+    {
+        return true;
+    }
+
+    fixture->active = false;
+
+    if (unit_test_invoke_fixture(fixture->teardown, fixture->suite, "teardown") == false)
+    {
+        printf("The teardown of suite %s failed.\n\n", fixture->suite);
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * A private function that fails a test case, without executing it,
+ * because the setup of the suite thereof failed.
+ */
+static void unit_test_skip_case (int32_t index)
+{
+    memset(&unit_test_cases[index].result, 0, sizeof(unit_test_case_result_t));
+    unit_test_report_start(index);
+    printf("The setup of the suite failed, so the test case was not executed.\n");
+    unit_test_report_end(index);
+}
+
+/**
+ * A private function that executes the given test cases, which are all in the same suite,
+ * between a single invocation of the setup and teardown functions of the suite, if any.
+ * The return value is false, if the teardown of the suite failed.
+ */
+static bool unit_test_run_suite (const int32_t* order, int32_t count)
+{
+    unit_test_suite_fixture_t* fixture = unit_test_find_suite_fixture(unit_test_cases[order[0]].suite);
+
+    unit_test_setup_suite(fixture);
+
+    for (int32_t k = 0; k < count; k++)
+    {
+        if (fixture != NULL && fixture->setup_failed)
+        {
+            unit_test_skip_case(order[k]);
+        }
+        else
+        {
+            unit_test_run_case(order[k]);
+        }
+    }
+
+    return unit_test_teardown_suite(fixture);
+}
+
+/**
+ * A private function that executes the enabled test cases in this process, one at a time.
+ * The test cases are grouped by suite, in the order in which each suite first appears,
+ * so that the fixture of each suite is set up and torn down only once,
+ * even if the test cases of the suite were not declared contiguously.
+ * The return value is false, if the teardown of any suite failed.
+ */
+static bool unit_test_run_serial ()
+{
+    int32_t* order = malloc(sizeof(int32_t) * 5 * (unit_test_count + 1));
+
+    if (order == NULL)
+    {
+        fprintf(stderr, "Unable to order the test cases, due to insufficient memory.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    int32_t* suites = order + unit_test_count + 1;
+    int32_t* grouped = suites + unit_test_count + 1;
+    int32_t* sizes = grouped + unit_test_count + 1;
+    int32_t* offsets = sizes + unit_test_count + 1;
+    int32_t count = 0;
+
+    // If requested, the first pass selects the test cases that failed during the previous run,
+    // and the second pass selects the rest; otherwise, the second pass selects every test case.
+    for (int pass = unit_test_failed_first ? 0 : 1; pass < 2; pass++)
+    {
+        for (int32_t i = 0; i < unit_test_count; i++)
+        {
+            if (unit_test_hot[i].enabled == false)
+            {
+                continue; // skip disabled test suites and/or test cases
+            }
+
+            bool failed = unit_test_failed_first && unit_test_previously_failed(i);
+
+            if (failed == (pass == 0))
+            {
+                order[count++] = i;
+            }
+        }
+    }
+
+    // Stably group the test cases by suite, wherein each suite is identified
+    // by the first test case declared therein, via a counting sort.
+    for (int32_t i = 0; i < unit_test_count; i++)
+    {
+        sizes[i] = 0;
+        offsets[i] = -1;
+    }
+
+    for (int32_t k = 0; k < count; k++)
+    {
+        suites[k] = unit_test_find_suite(unit_test_cases[order[k]].suite);
+        ++sizes[suites[k]];
+    }
+
+    for (int32_t k = 0, next = 0; k < count; k++)
+    {
+        if (offsets[suites[k]] < 0)
+        {
+            offsets[suites[k]] = next;
+            next += sizes[suites[k]];
+        }
+    }
+
+    for (int32_t k = 0; k < count; k++)
+    {
+        grouped[offsets[suites[k]]++] = order[k];
+    }
+
+    bool passed = true;
+
+    for (int32_t k = 0; k < count; )
+    {
+        int32_t length = sizes[unit_test_find_suite(unit_test_cases[grouped[k]].suite)];
+        passed &= unit_test_run_suite(grouped + k, length);
+        k += length;
+    }
+
+    free(order);
+    return passed;
+}
+
+/**
+ * The state of an entry in the work queue shared by the worker processes.
+ */
+typedef enum
+{
+    UNIT_TEST_SLOT_PENDING = 0,
+    UNIT_TEST_SLOT_CLAIMED,
+    UNIT_TEST_SLOT_DONE
+
+} unit_test_slot_state_t;
+
+/**
+ * Per test case bookkeeping in the work queue shared by the worker processes.
+ */
+typedef struct
+{
+    /**
+     * Whether the test case is waiting, running, or finished.
+     */
+    int32_t state;
+
+    /**
+     * The worker process that claimed the test case, if any.
+     */
+    pid_t worker;
+
+    /**
+     * The result of the test case, as reported by the worker.
+     */
+    unit_test_case_result_t result;
+
+    /**
+     * If the test case is a complexity test case, then this is the row of the costs thereof in the work queue; otherwise, -1.
+     */
+    int32_t costs;
+
+} unit_test_slot_t;
+
+/**
+ * The work queue that is shared by the worker processes, when running in parallel.
+ *
+ * The queue lives in an anonymous shared memory mapping, which is created
+ * before the workers are forked; therefore, the pointers herein are valid
+ * in both the parent process and the worker processes.
+ */
+typedef struct
+{
+    /**
+     * This is the position, in the order, of the next test case to claim.
+     * Workers atomically increment this in order to claim work.
+     */
+    int32_t next;
+
+    /**
+     * This is the number of enabled test cases in the order.
+     */
+    int32_t count;
+
+    /**
+     * This is a spin lock, which serializes the printing of test case reports,
+     * so that the output of concurrently executing test cases does not interleave.
+     */
+    int32_t output_lock;
+
+    /**
+     * These are the indexes of the enabled test cases in the order that they will be claimed.
+     */
+    int32_t* order;
+
+    /**
+     * These are the per test case bookkeeping entries, indexed by test case.
+     */
+    unit_test_slot_t* slots;
+
+    /**
+     * These are the costs of the complexity test cases, as reported by the workers,
+     * one row of UNIT_TEST_MAX_COMPLEXITY_SIZES per complexity test case.
+     */
+    double* costs;
+
+} unit_test_queue_t;
+
+/**
+ * The files of a worker process, which are created by the parent, before the worker is forked,
+ * so that the parent can replay the output of a test case, which crashed the worker.
+ */
+typedef struct
+{
+    /**
+     * The worker process, or zero, if none.
+     */
+    pid_t pid;
+
+    /**
+     * The file, to which the worker writes the report of the test case that it is executing, or -1.
+     */
+    int output;
+
+    /**
+     * The file, to which the worker redirects the output of the test case that it is executing,
+     * if capturing, before the report thereof is written, or -1.
+     */
+    int capture;
+
+} unit_test_worker_t;
+
+/**
+ * A private function used to sort the work queue, such that the test cases,
+ * which took the longest time during the previous execution, if any, run first.
+ * Thereby, a long test case does not start last and delay the end of the run.
+ * If requested, the test cases that failed during the previous run go first of all.
+ */
+static int unit_test_compare_duration (const void* left, const void* right)
+{
+    int32_t x = *(const int32_t*) left;
+    int32_t y = *(const int32_t*) right;
+    bool fx = unit_test_failed_first && unit_test_previously_failed(x);
+    bool fy = unit_test_failed_first && unit_test_previously_failed(y);
+    int64_t dx = unit_test_expected_duration(x);
+    int64_t dy = unit_test_expected_duration(y);
+
+    if (fx != fy)
+    {
+        return fx ? -1 : 1;
+    }
+
+    if (dx != dy)
+    {
+        return dx > dy ? -1 : 1;
+    }
+
+    return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+/**
+ * A private function that copies the report of a test case,
+ * which a worker captured in a temporary file, to the real output.
+ */
+static void unit_test_flush_capture (unit_test_queue_t* queue, int capture, int output)
+{
+    while (__atomic_exchange_n(&queue->output_lock, 1, __ATOMIC_ACQUIRE))
+    {
+        sched_yield();
+    }
+
+    unit_test_replay_capture(capture, output);
+
+    __atomic_store_n(&queue->output_lock, 0, __ATOMIC_RELEASE);
+}
+
+/**
+ * A private function that executes test cases from the shared work queue,
+ * in a worker process, until the work queue has been exhausted.
+ *
+ * The report of each test case is captured in the output file of the worker,
+ * while the test case executes, and then written out as a whole,
+ * so that the reports of the workers do not interleave.
+ * The standard output is line buffered meanwhile, so that each line that a test case prints
+ * reaches the file, and can be replayed by the parent, even if the test case crashes the worker.
+ */
+static void unit_test_work (unit_test_queue_t* queue, const unit_test_worker_t* worker)
+{
+    int capture = worker->output;
+    int output = dup(STDOUT_FILENO);
+
+    unit_test_in_worker = true;
+
+    // Capture the output of the test cases in the file created by the parent, rather than one of this process.
+    if (worker->capture >= 0 && unit_test_capture)
+    {
+        if (unit_test_capture_fd >= 0)
+        {
+            close(unit_test_capture_fd);
+        }
+
+        unit_test_capture_fd = worker->capture;
+        unit_test_capture_owner = getpid();
+    }
+
+    fflush(stdout);
+    setvbuf(stdout, NULL, _IOLBF, BUFSIZ);
+
+    for (;;)
+    {
+        int32_t position = __atomic_fetch_add(&queue->next, 1, __ATOMIC_ACQ_REL);
+
+        if (position >= queue->count)
+        {
+            break;
+        }
+
+        int32_t i = queue->order[position];
+        unit_test_slot_t* slot = &queue->slots[i];
+
+        slot->worker = getpid();
+        __atomic_store_n(&slot->state, UNIT_TEST_SLOT_CLAIMED, __ATOMIC_RELEASE);
+
+        if (capture >= 0 && output >= 0)
+        {
+            fflush(stdout);
+            dup2(capture, STDOUT_FILENO);
+        }
+
+        unit_test_run_case(i);
+        fflush(stdout);
+
+        if (capture >= 0 && output >= 0)
+        {
+            dup2(output, STDOUT_FILENO);
+            unit_test_flush_capture(queue, capture, output);
+        }
+
+        slot->result = unit_test_cases[i].result;
+
+        if (slot->costs >= 0)
+        {
+            memcpy(&queue->costs[slot->costs * UNIT_TEST_MAX_COMPLEXITY_SIZES], unit_test_cases[i].complexity_cost, sizeof(double) * UNIT_TEST_MAX_COMPLEXITY_SIZES);
+        }
+
+        __atomic_store_n(&slot->state, UNIT_TEST_SLOT_DONE, __ATOMIC_RELEASE);
+    }
+
+    if (output >= 0)
+    {
+        close(output);
+    }
+
+    unit_test_in_worker = false;
+}
+
+/**
+ * A private function that forks a worker process, which executes test cases
+ * from the shared work queue, and writes the output thereof to the files of the worker,
+ * which are created upon first use, and emptied, when a dead worker is replaced.
+ * The return value is the process ID of the worker,
+ * or a negative value, if the worker could not be created.
+ */
+static pid_t unit_test_spawn_worker (unit_test_queue_t* queue, unit_test_worker_t* worker)
+{
+    if (worker->output < 0)
+    {
+        worker->output = unit_test_create_capture();
+        worker->capture = unit_test_capture ? unit_test_create_capture() : -1;
+    }
+
+    // A dead worker may have left the partial output of a test case, which has already been replayed.
+    for (int k = 0; k < 2; k++)
+    {
+        int file = k == 0 ? worker->output : worker->capture;
+
+        if (file >= 0)
+        {
+            lseek(file, 0, SEEK_SET);
+            (void) ftruncate(file, 0);
+        }
+    }
+
+    // Otherwise, buffered output would be printed by both processes.
+    fflush(NULL);
+
+    pid_t pid = fork();
+
+    if (pid == 0)
+    {
+        unit_test_work(queue, worker);
+        fflush(NULL);
+        _exit(EXIT_SUCCESS);
+    }
+
+    worker->pid = pid > 0 ? pid : 0;
+    return pid;
+}
+
+/**
+ * A private function that reports a test case, which crashed the worker process that was executing it,
+ * along with whatever the test case printed before the crash, which the worker left in its files.
+ * The console report of the test case is finished on behalf of the worker, which, unless capturing,
+ * already reported the start of the test case to its output file; any other report is written with the others.
+ */
+static void unit_test_report_crash (unit_test_queue_t* queue, int32_t index, const unit_test_worker_t* worker)
+{
+    // The other workers may be writing their reports meanwhile.
+    while (__atomic_exchange_n(&queue->output_lock, 1, __ATOMIC_ACQUIRE))
+    {
+        sched_yield();
+    }
+
+    bool started = worker != NULL && worker->output >= 0 && lseek(worker->output, 0, SEEK_CUR) > 0;
+
+    if (unit_test_report_console && started == false)
+    {
+        unit_test_report_start(index);
+    }
+
+    fflush(stdout);
+
+    for (int k = 0; worker != NULL && k < 2; k++)
+    {
+        int file = k == 0 ? worker->output : worker->capture;
+
+        if (file >= 0)
+        {
+            unit_test_replay_capture(file, STDOUT_FILENO);
+        }
+    }
+
+    printf("The worker process terminated unexpectedly.\n");
+
+    if (unit_test_report_console)
+    {
+        unit_test_report_end(index);
+    }
+
+    fflush(stdout);
+
+    __atomic_store_n(&queue->output_lock, 0, __ATOMIC_RELEASE);
+}
+
+/**
+ * A private function that executes the enabled test cases in parallel,
+ * using the given number of worker processes, which pull the test cases
+ * from a shared work queue, and then merges the results thereof.
+ *
+ * If a worker dies while executing a test case (segmentation fault, etc),
+ * then that test case is failed, and a new worker replaces the dead one,
+ * provided that work remains in the queue.
+ */
+static bool unit_test_run_parallel (int32_t jobs)
+{
+    int32_t count = 0;
+    int32_t total = 0;
+    int32_t rows = 0;
+
+    for (int32_t i = 0; i < unit_test_count; i++)
+    {
+        count += unit_test_hot[i].enabled ? 1 : 0;
+        rows += unit_test_hot[i].enabled && unit_test_hot[i].kind == UNIT_TEST_KIND_COMPLEXITY ? 1 : 0;
+        ++total;
+    }
+
+    if (count == 0)
+    {
+        return true;
+    }
+
+    size_t size = sizeof(unit_test_queue_t) + sizeof(int32_t) * count + sizeof(unit_test_slot_t) * total + sizeof(double) * UNIT_TEST_MAX_COMPLEXITY_SIZES * rows;
+    void* memory = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+
+    if (memory == MAP_FAILED)
+    {
+        perror("Unable to create the work queue, so running serially");
+        return unit_test_run_serial();
+    }
+
+    // Set up the fixture of each suite exactly once, before the workers are forked,
+    // so that the workers inherit the already initialized state of every suite.
+    for (int32_t k = 0; k < unit_test_suite_fixture_count; k++)
+    {
+        unit_test_suite_fixture_t* fixture = &unit_test_suite_fixtures[k];
+        int32_t first = unit_test_find_suite(fixture->suite);
+        fixture->setup_failed = false;
+        fixture->active = false;
+
+        for (int32_t i = first; i >= 0; i = unit_test_suite_index.next[i])
+        {
+            if (unit_test_hot[i].enabled)
+            {
+                unit_test_setup_suite(fixture);
+                break;
+            }
+        }
+    }
+
+    unit_test_queue_t* queue = (unit_test_queue_t*) memory;
+    queue->order = (int32_t*) (queue + 1);
+    queue->slots = (unit_test_slot_t*) (queue->order + count);
+    queue->costs = (double*) (queue->slots + total);
+    queue->count = 0;
+    rows = 0;
+
+    for (int32_t i = 0; i < total; i++)
+    {
+        queue->slots[i].costs = unit_test_hot[i].enabled && unit_test_hot[i].kind == UNIT_TEST_KIND_COMPLEXITY ? rows++ : -1;
+
+        unit_test_suite_fixture_t* fixture = unit_test_find_suite_fixture(unit_test_cases[i].suite);
+
+        if (unit_test_hot[i].enabled && fixture != NULL && fixture->setup_failed)
+        {
+            unit_test_skip_case(i);
+        }
+        else if (unit_test_hot[i].enabled)
+        {
+            queue->order[queue->count++] = i;
+        }
+    }
+
+    count = queue->count;
+
+    qsort(queue->order, count, sizeof(int32_t), unit_test_compare_duration);
+
+    if (jobs > count)
+    {
+        jobs = count;
+    }
+
+    unit_test_worker_t* workers = malloc(sizeof(unit_test_worker_t) * jobs);
+    int32_t live = 0;
+
+    for (int32_t n = 0; workers != NULL && n < jobs; n++)
+    {
+        workers[n] = (unit_test_worker_t) { .pid = 0, .output = -1, .capture = -1 };
+    }
+
+    for (int32_t n = 0; workers != NULL && n < jobs; n++)
+    {
+        if (unit_test_spawn_worker(queue, &workers[n]) < 0)
+        {
+            perror("Unable to create a worker process");
+            break;
+        }
+
+        ++live;
+    }
+
+    // If not even one worker could be created,
+    // then this process must do all of the work.
+    if (live == 0)
+    {
+        unit_test_worker_t self = { .pid = 0, .output = unit_test_create_capture(), .capture = -1 };
+        unit_test_work(queue, &self);
+
+        if (self.output >= 0)
+        {
+            close(self.output);
+        }
+    }
+
+    while (live > 0)
+    {
+        int status = 0;
+        pid_t pid = wait(&status);
+
+        if (pid < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+
+            break;
+        }
+
+        --live;
+
+        unit_test_worker_t* worker = NULL;
+
+        for (int32_t n = 0; n < jobs; n++)
+        {
+            worker = workers[n].pid == pid ? &workers[n] : worker;
+        }
+
+        // Fail the test case that the worker was executing when it died, if any.
+        for (int32_t k = 0; k < count; k++)
+        {
+            int32_t i = queue->order[k];
+            unit_test_slot_t* slot = &queue->slots[i];
+
+            if (slot->worker == pid && __atomic_load_n(&slot->state, __ATOMIC_ACQUIRE) == UNIT_TEST_SLOT_CLAIMED)
+            {
+                slot->result.passed = false;
+                slot->result.timed_out = false;
+                slot->result.signal = WIFSIGNALED(status) ? WTERMSIG(status) : 0;
+                slot->state = UNIT_TEST_SLOT_DONE;
+
+                unit_test_cases[i].result = slot->result;
+                unit_test_report_crash(queue, i, worker);
+            }
+        }
+
+        // Replace the dead worker, if there is still work to do.
+        bool abnormal = WIFSIGNALED(status) || (WIFEXITED(status) && WEXITSTATUS(status) != EXIT_SUCCESS);
+
+        if (worker != NULL)
+        {
+            worker->pid = 0;
+        }
+
+        if (worker != NULL && abnormal && __atomic_load_n(&queue->next, __ATOMIC_ACQUIRE) < count)
+        {
+            if (unit_test_spawn_worker(queue, worker) >= 0)
+            {
+                ++live;
+            }
+        }
+    }
+
+    for (int32_t n = 0; workers != NULL && n < jobs; n++)
+    {
+        if (workers[n].output >= 0)
+        {
+            close(workers[n].output);
+        }
+
+        if (workers[n].capture >= 0)
+        {
+            close(workers[n].capture);
+        }
+    }
+
+    free(workers);
+
+    // Merge the results, which were reported by the workers.
+    for (int32_t k = 0; k < count; k++)
+    {
+        int32_t i = queue->order[k];
+        unit_test_slot_t* slot = &queue->slots[i];
+
+        if (slot->state == UNIT_TEST_SLOT_DONE)
+        {
+            unit_test_cases[i].result = slot->result;
+        }
+        else
+        {
+            // The test case was never executed, because every worker died.
+            unit_test_cases[i].result.passed = false;
+            unit_test_cases[i].result.elapsed_time_mono_ns = 0;
+        }
+
+        if (slot->costs >= 0)
+        {
+            memcpy(unit_test_cases[i].complexity_cost, &queue->costs[slot->costs * UNIT_TEST_MAX_COMPLEXITY_SIZES], sizeof(double) * UNIT_TEST_MAX_COMPLEXITY_SIZES);
+        }
+
+        // Unless the workers wrote the console report, they leave the reporting to this process, which only has the results now.
+        if (unit_test_report_console == false)
+        {
+            unit_test_report_start(i);
+            unit_test_report_end(i);
+        }
+    }
+
+    munmap(memory, size);
+
+    bool passed = true;
+
+    for (int32_t k = 0; k < unit_test_suite_fixture_count; k++)
+    {
+        passed &= unit_test_teardown_suite(&unit_test_suite_fixtures[k]);
+    }
+
+    return passed;
+}
+
+/**
+ * The measurement of a test case, as recorded in a baseline file.
+ */
+typedef struct
+{
+    /**
+     * True, if the baseline file contains an entry for the test case.
+     */
+    bool present;
+
+    /**
+     * The elapsed time of the test case, or the median time per operation of a benchmark,
+     * in nanoseconds.
+     */
+    double time_ns;
+
+    /**
+     * The noise in the time, which is the median absolute deviation of a benchmark,
+     * in nanoseconds, or zero, if the test case was only measured once.
+     */
+    double noise_ns;
+
+    /**
+     * The number of samples that the time is based on.
+     */
+    uint32_t samples;
+
+    /**
+     * The number of instructions retired by the body of the test case,
+     * or per operation of a benchmark, or zero, if not measured.
+     */
+    double instructions;
+
+} unit_test_baseline_t;
+
+/**
+ * True, if the instructions retired, rather than the time, shall be compared
+ * to the baselines, where both the baseline and measurement have them.
+ */
+static bool unit_test_baseline_instructions;
+
+/**
+ * A private function that obtains the measurement of a test case, which was just executed.
+ */
+static unit_test_baseline_t unit_test_measure (int32_t index)
+{
+    unit_test_case_result_t* result = &unit_test_cases[index].result;
+    unit_test_baseline_t measure = { .present = true };
+
+    if (unit_test_hot[index].kind == UNIT_TEST_KIND_BENCH)
+    {
+        measure.time_ns = result->bench.median_ns;
+        measure.noise_ns = result->bench.mad_ns;
+        measure.samples = result->bench.samples;
+        measure.instructions = result->bench.iterations > 0 ? ((double) result->perf.instructions) / ((double) result->bench.iterations) : 0;
+    }
+    else
+    {
+        measure.time_ns = (double) result->elapsed_time_mono_ns;
+        measure.noise_ns = 0;
+        measure.samples = 1;
+        measure.instructions = (double) result->perf.instructions;
+    }
+
+    return measure;
+}
+
+/**
+ * A private function that reads a baseline file, which contains one line per test case,
+ * of the form "suite/name time_ns noise_ns samples [instructions]", into the given per test case array.
+ * Entries for test cases that are not declared are ignored.
+ * The return value is false, if the file could not be read.
+ */
+static bool unit_test_load_baseline (const char* path, unit_test_baseline_t* baselines)
+{
+    FILE* file = fopen(path, "r");
+
+    if (file == NULL)
+    {
+        return false;
+    }
+
+    char line[4096];
+    char key[4096];
+
+    while (fgets(line, sizeof(line), file) != NULL)
+    {
+        unit_test_baseline_t entry = { .present = true };
+
+        if (line[0] == '#' || sscanf(line, "%4095s %lf %lf %u %lf", key, &entry.time_ns, &entry.noise_ns, &entry.samples, &entry.instructions) < 4)
+        {
+            continue; // skip comments and malformed lines
+        }
+
+        char* slash = strchr(key, '/');
+
+        if (slash == NULL)
+        {
+            continue;
+        }
+
+        *slash = '\0';
+
+        for (int32_t i = unit_test_find_case(key, slash + 1); i >= 0; i = unit_test_case_index.next[i])
+        {
+            baselines[i] = entry;
+        }
+    }
+
+    fclose(file);
+    return true;
+}
+
+/**
+ * A private function that writes a baseline file, which contains the given entries.
+ * The file is written to a temporary file first and then renamed,
+ * so that an interrupted run does not leave a truncated baseline.
+ * The return value is false, if the file could not be written.
+ */
+static bool unit_test_save_baseline (const char* path, const unit_test_baseline_t* baselines)
+{
+    size_t length = strlen(path);
+    char temporary[length + 5];
+    snprintf(temporary, sizeof(temporary), "%s.tmp", path);
+
+    FILE* file = fopen(temporary, "w");
+
+    if (file == NULL)
+    {
+        return false;
+    }
+
+    fprintf(file, "# suite/name time_ns noise_ns samples instructions\n");
+
+    for (int32_t i = 0; i < unit_test_count; i++)
+    {
+        if (baselines[i].present)
+        {
+            fprintf(file,
+                    "%s/%s %.3f %.3f %u %.1f\n",
+                    unit_test_cases[i].suite,
+                    unit_test_cases[i].name,
+                    baselines[i].time_ns,
+                    baselines[i].noise_ns,
+                    baselines[i].samples,
+                    baselines[i].instructions);
+        }
+    }
+
+    bool ok = (fclose(file) == 0);
+    return ok && rename(temporary, path) == 0;
+}
+
+/**
+ * A private function that determines whether the instructions retired,
+ * rather than the time, shall be compared to the baseline of a test case,
+ * which is only possible, if both the baseline and measurement have them.
+ */
+static bool unit_test_compares_instructions (const unit_test_baseline_t* baseline, const unit_test_baseline_t* current)
+{
+    return unit_test_baseline_instructions && baseline->instructions > 0 && current->instructions > 0;
+}
+
+/**
+ * A private function that compares a measurement to the baseline thereof.
+ *
+ * A raw ratio would flag noise as a regression, especially for short test cases;
+ * therefore, the change must exceed both the given percentage of the baseline
+ * and the noise. The noise of a benchmark is a multiple of the larger of the
+ * median absolute deviations. Test cases that are only measured once have
+ * no noise estimate; therefore, a fixed noise floor is used for them.
+ * The instructions retired are nearly deterministic, so the percentage suffices.
+ *
+ * The return value is positive for a regression, negative for an improvement,
+ * and zero, if the change is insignificant.
+ */
+static int unit_test_compare_baseline (const unit_test_baseline_t* baseline, const unit_test_baseline_t* current, double max_regression_percent)
+{
+    bool instructions = unit_test_compares_instructions(baseline, current);
+    double before = instructions ? baseline->instructions : baseline->time_ns;
+    double after = instructions ? current->instructions : current->time_ns;
+    double delta = after - before;
+    double magnitude = delta < 0 ? -delta : delta;
+    double noise = baseline->noise_ns > current->noise_ns ? baseline->noise_ns : current->noise_ns;
+
+    noise = (baseline->samples > 1 && current->samples > 1) ? UNIT_TEST_BASELINE_NOISE_FACTOR * noise : UNIT_TEST_BASELINE_NOISE_FLOOR_NS;
+    noise = instructions ? 0 : noise;
+
+    if (magnitude <= before * max_regression_percent / 100.0 || magnitude <= noise)
+    {
+        return 0;
+    }
+
+    return delta > 0 ? 1 : -1;
+}
+
+/**
+ * A private function that compares the executed test cases to the baselines thereof,
+ * and prints the test cases that regressed or improved significantly.
+ * The return value is the number of regressions.
+ */
+static int32_t unit_test_report_baseline (const unit_test_baseline_t* baselines, double max_regression_percent)
+{
+    int32_t counts[2] = { 0, 0 };
+    const char* labels[2] = { "Regressed Cases", "Improved  Cases" };
+
+    for (int direction = 0; direction < 2; direction++)
+    {
+        printf("%s:\n", labels[direction]);
+
+        for (int32_t i = 0; i < unit_test_count; i++)
+        {
+            if (unit_test_hot[i].enabled == false || unit_test_cases[i].result.passed == false || baselines[i].present == false)
+            {
+                continue;
+            }
+
+            unit_test_baseline_t current = unit_test_measure(i);
+            int comparison = unit_test_compare_baseline(&baselines[i], &current, max_regression_percent);
+
+            if (comparison == (direction == 0 ? 1 : -1))
+            {
+                bool instructions = unit_test_compares_instructions(&baselines[i], &current);
+                double before = instructions ? baselines[i].instructions : baselines[i].time_ns;
+                double after = instructions ? current.instructions : current.time_ns;
+
+                ++counts[direction];
+                printf("    %s/%s: %.1f %s -> %.1f %s (%+.1f%%)\n",
+                       unit_test_cases[i].suite,
+                       unit_test_cases[i].name,
+                       before,
+                       instructions ? "instructions" : "ns",
+                       after,
+                       instructions ? "instructions" : "ns",
+                       before > 0 ? 100.0 * (after - before) / before : 0.0);
+            }
+        }
+
+        if (counts[direction] == 0)
+        {
+            printf("    None\n");
+        }
+    }
+
+    return counts[0];
+}
+
+/**
+ * A private utility function used to sort test cases by elapsed time, in descending order.
+ */
+static int unit_test_compare_elapsed (const void* left, const void* right)
+{
+    int64_t x = unit_test_cases[*(const int32_t*) left].result.elapsed_time_mono_ns;
+    int64_t y = unit_test_cases[*(const int32_t*) right].result.elapsed_time_mono_ns;
+    return x > y ? -1 : (x < y ? 1 : 0);
+}
+
+/**
+ * A private utility function that obtains a phase of a test case, given (index * 3 + phase).
+ */
+static const unit_test_phase_time_t* unit_test_get_phase (int32_t key)
+{
+    unit_test_case_result_t* result = &unit_test_cases[key / 3].result;
+    return key % 3 == 0 ? &result->setup_time : (key % 3 == 1 ? &result->body_time : &result->teardown_time);
+}
+
+/**
+ * A private utility function used to sort the phases of test cases by wall time, in descending order.
+ */
+static int unit_test_compare_phase (const void* left, const void* right)
+{
+    int64_t x = unit_test_get_phase(*(const int32_t*) left)->wall_ns;
+    int64_t y = unit_test_get_phase(*(const int32_t*) right)->wall_ns;
+    return x > y ? -1 : (x < y ? 1 : 0);
+}
+
+/**
+ * A private function that prints the given number of slowest executed test cases,
+ * and the given number of slowest phases (setup, body, or teardown) thereof,
+ * so that slow fixtures can be told apart from slow code under test.
+ */
+static void unit_test_report_slowest (int32_t limit)
+{
+    int32_t* keys = malloc(sizeof(int32_t) * 3 * (unit_test_count + 1));
+    int32_t count = 0;
+    char wall[32];
+    char cpu[32];
+
+    if (keys == NULL)
+    {
+        return;
+    }
+
+    for (int32_t i = 0; i < unit_test_count; i++)
+    {
+        if (unit_test_hot[i].enabled)
+        {
+            keys[count++] = i;
+        }
+    }
+
+    qsort(keys, count, sizeof(int32_t), unit_test_compare_elapsed);
+
+    printf("Slowest Cases:\n");
+
+    for (int32_t k = 0; k < count && k < limit; k++)
+    {
+        unit_test_case_t* test = &unit_test_cases[keys[k]];
+
+        printf("    %2d. %s/%s: %s (CPU %s)\n",
+               k + 1,
+               test->suite,
+               test->name,
+               unit_test_format_time(wall, sizeof(wall), (double) test->result.elapsed_time_mono_ns),
+               unit_test_format_time(cpu, sizeof(cpu), (double) test->result.cpu_time_ns));
+    }
+
+    // Only the phases that actually exist are ranked.
+    count = 0;
+
+    for (int32_t i = 0; i < unit_test_count; i++)
+    {
+        if (unit_test_hot[i].enabled)
+        {
+            if (NULL != unit_test_hot[i].setup)
+            {
+                keys[count++] = i * 3 + 0;
+            }
+
+            keys[count++] = i * 3 + 1;
+
+            if (NULL != unit_test_hot[i].teardown)
+            {
+                keys[count++] = i * 3 + 2;
+            }
+        }
+    }
+
+    qsort(keys, count, sizeof(int32_t), unit_test_compare_phase);
+
+    printf("Slowest Phases:\n");
+
+    for (int32_t k = 0; k < count && k < limit; k++)
+    {
+        static const char* names[3] = { "setup", "body", "teardown" };
+        unit_test_case_t* test = &unit_test_cases[keys[k] / 3];
+        const unit_test_phase_time_t* phase = unit_test_get_phase(keys[k]);
+
+        printf("    %2d. %s/%s (%s): %s (CPU %s)\n",
+               k + 1,
+               test->suite,
+               test->name,
+               names[keys[k] % 3],
+               unit_test_format_time(wall, sizeof(wall), (double) phase->wall_ns),
+               unit_test_format_time(cpu, sizeof(cpu), (double) phase->cpu_ns));
+    }
+
+    free(keys);
+}
+
+/**
+ * The predicted durations of the test cases, which are used when sharding.
+ */
+static double* unit_test_predictions;
+
+/**
+ * A private utility function used to sort test cases by predicted duration, in descending order.
+ * Ties are broken by the stable hash of the name, so that every shard computes the same plan.
+ */
+static int unit_test_compare_prediction (const void* left, const void* right)
+{
+    int32_t x = *(const int32_t*) left;
+    int32_t y = *(const int32_t*) right;
+
+    if (unit_test_predictions[x] != unit_test_predictions[y])
+    {
+        return unit_test_predictions[x] > unit_test_predictions[y] ? -1 : 1;
+    }
+
+    uint64_t hx = unit_test_hash_case(unit_test_cases[x].suite, unit_test_cases[x].name);
+    uint64_t hy = unit_test_hash_case(unit_test_cases[y].suite, unit_test_cases[y].name);
+
+    if (hx != hy)
+    {
+        return hx < hy ? -1 : 1;
+    }
+
+    return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+/**
+ * A private function that assigns each enabled test case to one of the given number of shards.
+ *
+ * Without timings, a test case is assigned by the stable hash of its name, so the assignment
+ * is independent of the order of declaration and of which other test cases exist.
+ * With timings, which are in the format of a baseline file, the test cases are assigned
+ * greedily, longest first, to the least loaded shard, so that the shards finish at about
+ * the same time. Test cases without timings are predicted to take the mean known time,
+ * while benchmarks are predicted to take their time budget.
+ *
+ * The shard of each test case (or -1, if disabled) and the predicted load of each shard
+ * are stored in the given arrays. The return value is false, if memory is insufficient.
+ */
+static bool unit_test_plan_shards (int32_t shard_count, const unit_test_baseline_t* timings, int32_t* shards, double* loads)
+{
+    for (int32_t k = 0; k < shard_count; k++)
+    {
+        loads[k] = 0;
+    }
+
+    for (int32_t i = 0; i < unit_test_count; i++)
+    {
+        shards[i] = -1;
+    }
+
+    if (timings == NULL)
+    {
+        for (int32_t i = 0; i < unit_test_count; i++)
+        {
+            if (unit_test_hot[i].enabled)
+            {
+                shards[i] = (int32_t) (unit_test_hash_case(unit_test_cases[i].suite, unit_test_cases[i].name) % (uint64_t) shard_count);
+            }
+        }
+
+        return true;
+    }
+
+    int32_t* order = malloc(sizeof(int32_t) * (unit_test_count + 1));
+    unit_test_predictions = malloc(sizeof(double) * (unit_test_count + 1));
+
+    if (order == NULL || unit_test_predictions == NULL)
+    {
+        free(order);
+        free(unit_test_predictions);
+        unit_test_predictions = NULL;
+        return false;
+    }
+
+    double known = 0;
+    int32_t known_count = 0;
+    int32_t count = 0;
+
+    for (int32_t i = 0; i < unit_test_count; i++)
+    {
+        if (timings[i].present && unit_test_hot[i].kind != UNIT_TEST_KIND_BENCH)
+        {
+            known += timings[i].time_ns;
+            ++known_count;
+        }
+    }
+
+    double fallback = known_count > 0 ? known / known_count : 1.0;
+
+    for (int32_t i = 0; i < unit_test_count; i++)
+    {
+        if (unit_test_hot[i].kind == UNIT_TEST_KIND_BENCH)
+        {
+            unit_test_predictions[i] = (double) unit_test_bench_time_ns;
+        }
+        else
+        {
+            unit_test_predictions[i] = timings[i].present ? timings[i].time_ns : fallback;
+        }
+
+        if (unit_test_hot[i].enabled)
+        {
+            order[count++] = i;
+        }
+    }
+
+    qsort(order, count, sizeof(int32_t), unit_test_compare_prediction);
+
+    for (int32_t k = 0; k < count; k++)
+    {
+        int32_t lightest = 0;
+
+        for (int32_t shard = 1; shard < shard_count; shard++)
+        {
+            lightest = loads[shard] < loads[lightest] ? shard : lightest;
+        }
+
+        shards[order[k]] = lightest;
+        loads[lightest] += unit_test_predictions[order[k]];
+    }
+
+    free(order);
+    free(unit_test_predictions);
+    unit_test_predictions = NULL;
+    return true;
+}
+
+/**
+ * A private function that prints the test cases assigned to each shard,
+ * along with the predicted duration thereof, if timings were given.
+ */
+static void unit_test_print_shards (int32_t shard_count, const int32_t* shards, const double* loads, bool predicted)
+{
+    char duration[32];
+
+    for (int32_t shard = 0; shard < shard_count; shard++)
+    {
+        int32_t count = 0;
+
+        for (int32_t i = 0; i < unit_test_count; i++)
+        {
+            count += shards[i] == shard ? 1 : 0;
+        }
+
+        if (predicted)
+        {
+            printf("Shard %d of %d: %d test cases, predicted %s\n", shard, shard_count, count, unit_test_format_time(duration, sizeof(duration), loads[shard]));
+        }
+        else
+        {
+            printf("Shard %d of %d: %d test cases\n", shard, shard_count, count);
+        }
+
+        for (int32_t i = 0; i < unit_test_count; i++)
+        {
+            if (shards[i] == shard)
+            {
+                printf("    %s/%s\n", unit_test_cases[i].suite, unit_test_cases[i].name);
+            }
+        }
+    }
+}
+
+/**
+ * A private function, which is invoked for each loaded object, that finds the GNU build ID
+ * of the executable, which is the first object, and formats it as hexadecimal.
+ */
+static int unit_test_find_build_id (struct dl_phdr_info* info, size_t size, void* data)
+{
+    char* hex = (char*) data;
+
+    for (int k = 0; k < info->dlpi_phnum; k++)
+    {
+        const ElfW(Phdr)* segment = &info->dlpi_phdr[k];
+
+        if (segment->p_type != PT_NOTE)
+        {
+            continue;
+        }
+
+        const char* note = (const char*) (info->dlpi_addr + segment->p_vaddr);
+        const char* end = note + segment->p_memsz;
+
+        while (note + sizeof(ElfW(Nhdr)) <= end)
+        {
+            const ElfW(Nhdr)* header = (const ElfW(Nhdr)*) note;
+            const char* name = note + sizeof(ElfW(Nhdr));
+            const unsigned char* description = (const unsigned char*) name + ((header->n_namesz + 3) & ~3U);
+
+            if (header->n_type == NT_GNU_BUILD_ID && header->n_namesz == 4 && 0 == memcmp(name, "GNU", 4))
+            {
+                for (uint32_t b = 0; b < header->n_descsz && b < UNIT_TEST_BUILD_ID_SIZE / 2; b++)
+                {
+                    snprintf(hex + 2 * b, 3, "%02x", description[b]);
+                }
+
+                return 1;
+            }
+
+            note = (const char*) description + ((header->n_descsz + 3) & ~3U);
+        }
+    }
+
+    return 1; // Stop after the executable.
+}
+
+/**
+ * A private function that obtains the GNU build ID of the executable,
+ * which identifies the exact binary that recorded an outcome in the state file,
+ * or "unknown", if the executable was linked without a build ID.
+ */
+static const char* unit_test_get_build_id ()
+{
+    static char build_id[UNIT_TEST_BUILD_ID_SIZE + 1] = "";
+
+    if (build_id[0] == '\0')
+    {
+        dl_iterate_phdr(unit_test_find_build_id, build_id);
+
+        if (build_id[0] == '\0')
+        {
+            snprintf(build_id, sizeof(build_id), "unknown");
+        }
+    }
+
+    return build_id;
+}
+
+/**
+ * A private function that reads the state file, which contains one line per test case,
+ * of the form "suite/name PASS|FAIL elapsed_ns build_id", into the per test case history.
+ * Entries for test cases that are not declared are ignored.
+ */
+static void unit_test_load_state (const char* path, unit_test_history_t* history)
+{
+    FILE* file = fopen(path, "r");
+
+    if (file == NULL)
+    {
+        return; // There is no history, yet.
+    }
+
+    char line[4096];
+    char key[4096];
+    char outcome[8];
+    char build_id[UNIT_TEST_BUILD_ID_SIZE + 1];
+
+    while (fgets(line, sizeof(line), file) != NULL)
+    {
+        long long elapsed = 0;
+
+        if (line[0] == '#' || sscanf(line, "%4095s %7s %lld %64s", key, outcome, &elapsed, build_id) != 4)
+        {
+            continue; // skip comments and malformed lines
+        }
+
+        char* slash = strchr(key, '/');
+
+        if (slash == NULL)
+        {
+            continue;
+        }
+
+        *slash = '\0';
+
+        for (int32_t i = unit_test_find_case(key, slash + 1); i >= 0; i = unit_test_case_index.next[i])
+        {
+            history[i].present = true;
+            history[i].passed = 0 == strcmp("PASS", outcome);
+            history[i].elapsed_time_mono_ns = elapsed;
+            snprintf(history[i].build_id, sizeof(history[i].build_id), "%s", build_id);
+        }
+    }
+
+    fclose(file);
+}
+
+/**
+ * A private function that writes the state file, which contains the outcome of each test case
+ * that was executed now, and the previous outcome of each test case that was not.
+ * The file is written to a temporary file first and then renamed,
+ * so that an interrupted run does not leave a truncated state.
+ * The return value is false, if the file could not be written.
+ */
+static bool unit_test_save_state (const char* path, const unit_test_history_t* history)
+{
+    size_t length = strlen(path);
+    char temporary[length + 5];
+    snprintf(temporary, sizeof(temporary), "%s.tmp", path);
+
+    FILE* file = fopen(temporary, "w");
+
+    if (file == NULL)
+    {
+        return false;
+    }
+
+    fprintf(file, "# suite/name outcome elapsed_ns build_id\n");
+
+    for (int32_t i = 0; i < unit_test_count; i++)
+    {
+        unit_test_case_t* test = &unit_test_cases[i];
+
+        if (unit_test_hot[i].enabled)
+        {
+            fprintf(file,
+                    "%s/%s %s %lld %s\n",
+                    test->suite,
+                    test->name,
+                    test->result.passed ? "PASS" : "FAIL",
+                    (long long) test->result.elapsed_time_mono_ns,
+                    unit_test_get_build_id());
+        }
+        else if (history[i].present)
+        {
+            fprintf(file,
+                    "%s/%s %s %lld %s\n",
+                    test->suite,
+                    test->name,
+                    history[i].passed ? "PASS" : "FAIL",
+                    (long long) history[i].elapsed_time_mono_ns,
+                    history[i].build_id);
+        }
+    }
+
+    bool ok = (fclose(file) == 0);
+    return ok && rename(temporary, path) == 0;
+}
+
+/**
+ * A private function that finds the test case named by the first field of a line of the coverage map, if any, or -1.
+ */
+static int32_t unit_test_find_mapped_case (char* line)
+{
+    line[strcspn(line, " \n")] = '\0';
+    char* slash = strchr(line, '/');
+
+    if (line[0] == '#' || slash == NULL)
+    {
+        return -1;
+    }
+
+    *slash = '\0';
+    return unit_test_find_case(line, slash + 1);
+}
+
+/**
+ * A private function that only enables the test cases that cover any of the given files, according to the coverage map,
+ * which are separated by commas or whitespace, such as the output of git diff --name-only.
+ * The test cases that are not in the map, such as new test cases, are enabled too, since their coverage is unknown,
+ * and every test case is enabled, if this library itself changed. If no test cases were selected,
+ * then consider all of the test cases.
+ */
+static void unit_test_select_impacted (const char* path, const char* changed, bool selected)
+{
+    size_t changed_length = strlen(changed);
+    char files[changed_length + 1];
+    const char* file_list[changed_length / 2 + 1];
+    size_t file_lengths[changed_length / 2 + 1];
+    int32_t file_count = 0;
+    bool harness = false;
+
+    memcpy(files, changed, changed_length + 1);
+
+    for (char* save = NULL, * file = strtok_r(files, ", \t\n", &save); file != NULL; file = strtok_r(NULL, ", \t\n", &save))
+    {
+        file_list[file_count] = file;
+        file_lengths[file_count] = strlen(file);
+        harness = harness || unit_test_is_harness(file, file_lengths[file_count]);
+        ++file_count;
+    }
+
+    bool* mapped = calloc(unit_test_count + 1, sizeof(bool));
+    bool* impacted = calloc(unit_test_count + 1, sizeof(bool));
+    FILE* map = fopen(path, "r");
+    char* line = NULL;
+    size_t capacity = 0;
+
+    if (map == NULL)
+    {
+        printf("There is no coverage map, so every test case is impacted: %s\n", path);
+    }
+
+    while (map != NULL && mapped != NULL && impacted != NULL && getline(&line, &capacity, map) > 0)
+    {
+        // Each field, after the name of the test case, is a source file, followed by a colon and the functions.
+        size_t fields = strcspn(line, " \n");
+        bool covers = false;
+
+        for (char* field = line + fields; *field == ' ' && covers == false; field += strcspn(field + 1, " \n") + 1)
+        {
+            const char* file = field + 1;
+            size_t length = strcspn(file, ": \n");
+
+            for (int32_t k = 0; k < file_count && covers == false; k++)
+            {
+                covers = unit_test_same_file(file, length, file_list[k], file_lengths[k]);
+            }
+        }
+
+        for (int32_t i = unit_test_find_mapped_case(line); i >= 0; i = unit_test_case_index.next[i])
+        {
+            mapped[i] = true;
+            impacted[i] = covers;
+        }
+    }
+
+    for (int32_t i = 0; mapped != NULL && impacted != NULL && i < unit_test_count; i++)
+    {
+        unit_test_hot[i].enabled = (unit_test_hot[i].enabled || selected == false) && (harness || impacted[i] || mapped[i] == false);
+    }
+
+    if (map != NULL)
+    {
+        fclose(map);
+    }
+
+    free(line);
+    free(mapped);
+    free(impacted);
+}
+
+/**
+ * A private function that writes the coverage map, which contains the lines that were appended by the test cases
+ * that were executed now, and the previous lines of the test cases that were not. A test case that crashed
+ * before the coverage thereof was recorded is therefore absent from the map, and always considered impacted.
+ * The file is written to a temporary file first and then renamed, like the state file.
+ * The return value is false, if the file could not be written.
+ */
+static bool unit_test_save_coverage (const char* path, const char* recorded_path)
+{
+    size_t length = strlen(path);
+    char temporary[length + 5];
+    snprintf(temporary, sizeof(temporary), "%s.tmp", path);
+
+    FILE* recorded = fopen(recorded_path, "r");
+    FILE* previous = fopen(path, "r");
+    FILE* file = recorded != NULL ? fopen(temporary, "w") : NULL;
+    char* line = NULL;
+    size_t capacity = 0;
+    ssize_t count = 0;
+
+    if (file != NULL)
+    {
+        fprintf(file, "# suite/name file:function,function ...\n");
+    }
+
+    while (file != NULL && (count = getline(&line, &capacity, recorded)) > 0)
+    {
+        fwrite(line, 1, (size_t) count, file);
+    }
+
+    while (file != NULL && previous != NULL && (count = getline(&line, &capacity, previous)) > 0)
+    {
+        bool newline = line[count - 1] == '\n';
+        char* copy = strndup(line, (size_t) count);
+        int32_t index = copy != NULL ? unit_test_find_mapped_case(copy) : -1;
+
+        if (index >= 0 && unit_test_hot[index].enabled == false)
+        {
+            fwrite(line, 1, (size_t) count, file);
+            fputs(newline ? "" : "\n", file);
+        }
+
+        free(copy);
+    }
+
+    free(line);
+
+    if (previous != NULL)
+    {
+        fclose(previous);
+    }
+
+    if (recorded != NULL)
+    {
+        fclose(recorded);
+        unlink(recorded_path);
+    }
+
+    bool ok = file != NULL && (fclose(file) == 0);
+    return ok && rename(temporary, path) == 0;
+}
+
+/**
+ * This is a test module, namely a shared object, whose self-registered test cases are loaded via dlopen.
+ */
+typedef struct
+{
+    /**
+     * This is the path of the shared object.
+     */
+    const char* path;
+
+    /**
+     * This is the handle of the loaded copy of the shared object, or NULL, if it is not loaded.
+     */
+    void* handle;
+
+    /**
+     * This is the status of the shared object, when it was loaded, so that a rebuild can be detected.
+     */
+    struct stat status;
+
+} unit_test_module_t;
+
+/**
+ * These are the test modules given via --module.
+ */
+static unit_test_module_t unit_test_modules[UNIT_TEST_MAX_MODULES];
+static int32_t unit_test_module_count;
+
+/**
+ * A private function that finds the section of the descriptors of the self-registered test cases in the contents
+ * of a shared object, since the linker only defines the symbols that delimit the section, if they are referenced,
+ * which only this library does. The return value is false, if the shared object has no such section.
+ */
+static bool unit_test_find_descriptors (const uint8_t* contents, size_t size, ElfW(Addr)* address, size_t* length)
+{
+    const ElfW(Ehdr)* header = (const ElfW(Ehdr)*) contents;
+
+    if (size < sizeof(ElfW(Ehdr))
+        || memcmp(header->e_ident, ELFMAG, SELFMAG) != 0
+        || header->e_shentsize != sizeof(ElfW(Shdr))
+        || header->e_shoff > size
+        || (size - header->e_shoff) / sizeof(ElfW(Shdr)) < header->e_shnum
+        || header->e_shstrndx >= header->e_shnum)
+    {
+        return false;
+    }
+
+    const ElfW(Shdr)* sections = (const ElfW(Shdr)*) (contents + header->e_shoff);
+    const ElfW(Shdr)* names = &sections[header->e_shstrndx];
+
+    for (int k = 0; k < header->e_shnum && names->sh_offset < size; k++)
+    {
+        const char* name = (const char*) contents + names->sh_offset + sections[k].sh_name;
+
+        if (sections[k].sh_name < names->sh_size
+            && names->sh_offset + names->sh_size <= size
+            && strnlen(name, names->sh_size - sections[k].sh_name) == sizeof("unit_test_cases") - 1
+            && 0 == strcmp(name, "unit_test_cases"))
+        {
+            *address = sections[k].sh_addr;
+            *length = sections[k].sh_size;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * A private function that (re)loads a test module, and declares the self-registered test cases thereof,
+ * which replace the test cases of the previously loaded copy, if any. A private copy of the shared object
+ * is loaded, so that dlopen does not merely return the handle of the old copy, and so that the build
+ * can overwrite the shared object, while it is loaded. If the new copy cannot be loaded, such as
+ * if the build is still writing it, then the old copy is kept.
+ *
+ * The test module must not link unit_test.c itself, but resolve the functions thereof from the program,
+ * which must therefore be linked with -rdynamic.
+ *
+ * The return value is false, if the module could not be loaded.
+ */
+static bool unit_test_load_module (int32_t module)
+{
+    unit_test_module_t* loaded = &unit_test_modules[module];
+    const char* temporary = getenv("TMPDIR");
+    char copy[4096];
+    struct stat status;
+    size_t size = 0;
+    uint8_t* contents = stat(loaded->path, &status) == 0 ? unit_test_read_file(loaded->path, &size) : NULL;
+
+    snprintf(copy, sizeof(copy), "%s/unit_test_module_XXXXXX.so", temporary != NULL ? temporary : "/tmp");
+
+    int fd = contents != NULL ? mkstemps(copy, 3) : -1;
+    bool copied = fd >= 0 && write(fd, contents, size) == (ssize_t) size;
+
+    if (fd >= 0)
+    {
+        close(fd);
+    }
+
+    if (copied == false)
+    {
+        printf("Unable to copy the test module: %s\n", loaded->path);
+        unlink(copy);
+        free(contents);
+        return false;
+    }
+
+    void* handle = dlopen(copy, RTLD_NOW | RTLD_LOCAL);
+    struct link_map* map = NULL;
+    unlink(copy);
+
+    if (handle == NULL || dlinfo(handle, RTLD_DI_LINKMAP, &map) != 0)
+    {
+        printf("Unable to load the test module: %s\n", dlerror());
+        free(contents);
+        return false;
+    }
+
+    if (loaded->handle != NULL)
+    {
+        unit_test_forget_module(module + 1);
+        dlclose(loaded->handle);
+    }
+
+    loaded->handle = handle;
+    loaded->status = status;
+
+    // The descriptors were relocated when loaded, so they are read from memory, rather than the file.
+    ElfW(Addr) address = 0;
+    size_t length = 0;
+
+    if (unit_test_find_descriptors(contents, size, &address, &length))
+    {
+        const unit_test_descriptor_t* start = (const unit_test_descriptor_t*) (map->l_addr + address);
+        unit_test_declaring_module = module + 1;
+        unit_test_declare_descriptors(start, start + length / sizeof(unit_test_descriptor_t));
+        unit_test_declaring_module = 0;
+    }
+
+    free(contents);
+    return true;
+}
+
+/**
+ * A private function that reloads the test modules that changed since they were loaded.
+ * The return value is the number of test modules that were reloaded.
+ */
+static int32_t unit_test_reload_modules ()
+{
+    int32_t reloaded = 0;
+
+    for (int32_t k = 0; k < unit_test_module_count; k++)
+    {
+        const struct stat* old = &unit_test_modules[k].status;
+        struct stat status;
+
+        if (stat(unit_test_modules[k].path, &status) != 0)
+        {
+            continue; // The module is being rebuilt, so keep the old copy for now.
+        }
+
+        bool changed = status.st_ino != old->st_ino
+                       || status.st_size != old->st_size
+                       || status.st_mtim.tv_sec != old->st_mtim.tv_sec
+                       || status.st_mtim.tv_nsec != old->st_mtim.tv_nsec;
+
+        if (changed && unit_test_load_module(k))
+        {
+            ++reloaded;
+        }
+    }
+
+    return reloaded;
+}
+
+/**
+ * A private function that splits a command into words, in place, which are separated by whitespace,
+ * unless quoted by single or double quotes, like a shell would. The return value is the number of words.
+ */
+static int unit_test_split_command (char* line, const char** words, int capacity)
+{
+    int count = 0;
+    char* read = line;
+    char* write = line;
+
+    while (count < capacity)
+    {
+        while (*read == ' ' || *read == '\t' || *read == '\r' || *read == '\n')
+        {
+            ++read;
+        }
+
+        if (*read == '\0')
+        {
+            break;
+        }
+
+        char quote = '\0';
+        words[count++] = write;
+
+        while (*read != '\0' && (quote != '\0' || (*read != ' ' && *read != '\t' && *read != '\r' && *read != '\n')))
+        {
+            if (quote == '\0' && (*read == '"' || *read == '\''))
+            {
+                quote = *read++;
+            }
+            else if (*read == quote)
+            {
+                quote = '\0';
+                ++read;
+            }
+            else
+            {
+                *write++ = *read++;
+            }
+        }
+
+        // The terminator never overwrites an unread character, since the write position never passes the read position.
+        read += *read != '\0';
+        *write++ = '\0';
+    }
+
+    return count;
+}
+
+/**
+ * A private function that executes the commands, one per line, which are read from the given stream,
+ * and writes the output thereof to the given file descriptor, such as a connection to the socket.
+ * The return value is false, if a command asked the runner to quit.
+ */
+static bool unit_test_serve_commands (const char* program, FILE* commands, int output)
+{
+    char* line = NULL;
+    size_t capacity = 0;
+    bool quit = false;
+
+    while (quit == false && getline(&line, &capacity, commands) > 0)
+    {
+        const char* words[UNIT_TEST_MAX_COMMAND_WORDS + 2];
+        int count = unit_test_split_command(line, words + 1, UNIT_TEST_MAX_COMMAND_WORDS);
+
+        if (count == 0)
+        {
+            continue;
+        }
+
+        // The output of the command, and of any processes forked thereby, goes to the client.
+        int saved_stdout = dup(STDOUT_FILENO);
+        int saved_stderr = dup(STDERR_FILENO);
+
+        fflush(NULL);
+        dup2(output, STDOUT_FILENO);
+        dup2(output, STDERR_FILENO);
+
+        if (0 == strcmp("run", words[1]))
+        {
+            unit_test_reload_modules();
+
+            // The words of the command are the options of an ordinary run, such as: run --filter 'Suite/*' --jobs 4
+            words[0] = program;
+            words[1] = "--test";
+            words[count + 1] = NULL;
+            unit_test_run(count + 1, words);
+        }
+        else if (0 == strcmp("reload", words[1]))
+        {
+            printf("Reloaded %d test modules.\n", unit_test_reload_modules());
+        }
+        else if (0 == strcmp("quit", words[1]) || 0 == strcmp("exit", words[1]))
+        {
+            quit = true;
+        }
+        else
+        {
+            printf("Unknown command: %s\n", words[1]);
+            printf("Commands: run [<options>], reload, quit\n");
+        }
+
+        fflush(NULL);
+        dup2(saved_stdout, STDOUT_FILENO);
+        dup2(saved_stderr, STDERR_FILENO);
+        close(saved_stdout);
+        close(saved_stderr);
+    }
+
+    free(line);
+    return quit == false;
+}
+
+/**
+ * A private function that implements --serve, whereupon the runner stays resident, so that the global fixtures,
+ * and anything else that is expensive to initialize, stay alive between runs. The commands are read from stdin,
+ * or from each connection to a Unix socket in turn, if given. Before each run, the test modules that changed
+ * are reloaded, so that the edit, build, and test loop need not relink or restart the program.
+ */
+static int unit_test_serve (const char* program, const char* socket_path)
+{
+    if (unit_test_invoke_fixture(unit_test_global_setup, NULL, "setup") == false)
+    {
+        printf("The global setup failed, so the runner did not start.\n");
+        return EXIT_FAILURE;
+    }
+
+    // A client that disconnects early must not kill the runner.
+    signal(SIGPIPE, SIG_IGN);
+    unit_test_resident = true;
+
+    int listener = -1;
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+
+    if (socket_path != NULL && strlen(socket_path) < sizeof(address.sun_path))
+    {
+        snprintf(address.sun_path, sizeof(address.sun_path), "%s", socket_path);
+        unlink(socket_path);
+        listener = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+
+        if (listener >= 0 && (bind(listener, (struct sockaddr*) &address, sizeof(address)) != 0 || listen(listener, 8) != 0))
+        {
+            close(listener);
+            listener = -1;
+        }
+    }
+
+    bool serving = socket_path == NULL || listener >= 0;
+
+    if (serving == false)
+    {
+        printf("Unable to listen on the socket: %s\n", socket_path);
+    }
+    else if (listener < 0)
+    {
+        unit_test_serve_commands(program, stdin, STDOUT_FILENO);
+    }
+    else
+    {
+        printf("Listening on %s\n", socket_path);
+        fflush(stdout);
+    }
+
+    while (listener >= 0 && serving)
+    {
+        int connection = accept4(listener, NULL, NULL, SOCK_CLOEXEC);
+        FILE* commands = connection >= 0 ? fdopen(connection, "r") : NULL;
+
+        if (commands != NULL)
+        {
+            serving = unit_test_serve_commands(program, commands, connection);
+            fclose(commands);
+        }
+        else if (connection >= 0)
+        {
+            close(connection);
+        }
+        else
+        {
+            serving = errno == EINTR;
+        }
+    }
+
+    if (listener >= 0)
+    {
+        close(listener);
+        unlink(socket_path);
+    }
+
+    unit_test_resident = false;
+    bool global_teardown_passed = unit_test_invoke_fixture(unit_test_global_teardown, NULL, "teardown");
+
+    if (global_teardown_passed == false)
+    {
+        printf("The global teardown failed.\n");
+    }
+
+    return (listener >= 0 || socket_path == NULL) && global_teardown_passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/**
+ * Invoke this function in order to run the unit tests.
+ */
+int unit_test_run (int argc, const char** argv)
+{
+    bool run_tests = false;
+
+    // Only execute unit tests, if the --test flag is given,
+    // because the caller may have compiled their program
+    // with unit-tests always present and also merely passed
+    // us their command-lines arguments; therefore, we want
+    // to make their life easier by only executing tests
+    // when it is clear that is the desired behavior.
+    for (int n = 0; n < argc; n++)
+    {
+        if (0 == strcmp("--test", argv[n]))
+        {
+            run_tests = true;
+        }
+    }
+
+    if (run_tests == false)
+    {
+        return EXIT_FAILURE;
+    }
+
+    // The test cases, fixtures, and assertions thereof are executed on this thread.
+    unit_test_runner_thread = true;
+
+    // Append the self-registered test cases after the test cases declared at runtime.
+    unit_test_declare_registered();
+
+    // Print help.
+    for (int n = 0; n < argc; n++)
+    {
+        if ((0 == strcmp("--help", argv[n])) || (0 == strcmp("-h", argv[n])))
+        {
+            printf("Unit Test Help:\n");
+            printf("    --test:                        Activate the unit test runner.\n");
+            printf("    --all, -a:                     Enable all unit test suites and test cases.\n");
+            printf("    --enable-suite  <suite>:       Enable the named unit test suite.\n");
+            printf("    --disable-suite <suite>:       Disable the named unit test suite.\n");
+            printf("    --enable-case  <suite> <name>: Enable the named unit test case.\n");
+            printf("    --disable-case <suite> <name>: Disable the named unit test case.\n");
+            printf("    --filter <suite>/<name>:       Enable the test cases matching the glob pattern.\n");
+            printf("    --list:                        List the selected test cases without running them.\n");
+            printf("    --jobs, -j <count>:            Run the test cases in <count> worker processes.\n");
+            printf("                                   A <count> of zero means one per processor.\n");
+            printf("    --isolate:                     Run each test case in a child process of its own.\n");
+            printf("    --capture:                     Capture the output of each test case, and only print it on failure.\n");
+            printf("    --verbose:                     Print the captured output and full report of passing test cases too.\n");
+            printf("    --poison-arena:                Overwrite the arena allocations of each test case after the teardown.\n");
+            printf("    --reporter <name>:             Report the results as 'text' (default), 'junit' XML, or 'jsonl'.\n");
+            printf("    --output <file>:               Write the report to <file>, rather than the standard output.\n");
+            printf("    --timeout <ms>:                Kill isolated test cases that exceed <ms> milliseconds.\n");
+            printf("    --rows <first>[-<last>]:       Only execute the given rows of the table-driven test cases.\n");
+            printf("    --seed <seed>:                 Generate the inputs of the properties from <seed>.\n");
+            printf("    --property-runs <count>:       Run each property up to <count> times (default 1000).\n");
+            printf("    --property-time <ms>:          Run each property for at most <ms> milliseconds (default 1000).\n");
+            printf("    --rounds <count>:              Run each concurrent test case for <count> rounds (default 100).\n");
+            printf("    --bench-time <ms>:             Run each benchmark and complexity test case for about <ms> milliseconds.\n");
+            printf("    --track-resources:             Count and report the allocations, file descriptors, and RSS of each test case.\n");
+            printf("    --perf-counters:               Measure the cycles, instructions, and misses of each test case.\n");
+            printf("    --slowest <count>:             Summarize the <count> slowest test cases and phases thereof.\n");
+            printf("    --trace <file>:                Write a timeline of the test cases and phases in the Chrome trace format.\n");
+            printf("    --shard-count <count>:         Split the selected test cases into <count> shards.\n");
+            printf("    --shard-index <index>:         Only execute the test cases in the zero-based shard.\n");
+            printf("    --shard-timings <file>:        Balance the shards by the times in a baseline <file>.\n");
+            printf("    --rerun-failed:                Only execute the test cases that failed during the last run.\n");
+            printf("    --failed-first:                Execute the test cases that failed during the last run first.\n");
+            printf("    --state-file <file>:           Remember the outcomes in <file> (default: <program>.state).\n");
+            printf("    --no-state:                    Do not remember the outcomes of the test cases.\n");
+            printf("    --collect-coverage:            Map each test case to the source files and functions it covers.\n");
+            printf("    --coverage-map <file>:         Read and write the map in <file> (default: <program>.coverage).\n");
+            printf("    --impacted-by <files>:         Only execute the test cases that cover any of the comma-separated <files>.\n");
+            printf("    --save-baseline <file>:        Save the time of each passing test case to <file>.\n");
+            printf("    --compare-baseline <file>:     Fail, if any test case is significantly slower than in <file>.\n");
+            printf("    --max-regression <percent>:    Tolerate slowdowns up to <percent> percent (default 10).\n");
+            printf("    --baseline-metric <metric>:    Compare either the 'time' (default) or the 'instructions'.\n");
+            printf("    --module <file>:               Load the self-registered test cases of a shared object.\n");
+            printf("    --serve:                       Stay resident and execute commands (run, reload, quit) from stdin.\n");
+            printf("    --socket <path>:               Read the commands of --serve from connections to a Unix socket.\n");
+            printf("    --help, -h:                    Print this help message.\n");
+            return EXIT_SUCCESS;
+        }
+    }
+
+    // Optionally, load the test cases of test modules, and stay resident, so that the modules can be
+    // rebuilt and reloaded, without restarting the program, or executing the global fixtures again.
+    // Once resident, each command is an ordinary run, whose options are the words of the command.
+    if (unit_test_resident == false)
+    {
+        bool serve = false;
+        const char* socket_path = NULL;
+
+        for (int n = 0; n < argc; n++)
+        {
+            if (0 == strcmp("--module", argv[n]) && n < argc - 1 && unit_test_module_count < UNIT_TEST_MAX_MODULES)
+            {
+                unit_test_modules[unit_test_module_count].path = argv[n + 1];
+
+                if (unit_test_load_module(unit_test_module_count++) == false)
+                {
+                    return EXIT_FAILURE;
+                }
+            }
+            else if (0 == strcmp("--socket", argv[n]) && n < argc - 1)
+            {
+                socket_path = argv[n + 1];
+                serve = true;
+            }
+            else if (0 == strcmp("--serve", argv[n]))
+            {
+                serve = true;
+            }
+        }
+
+        if (serve)
+        {
+            return unit_test_serve(argv[0], socket_path);
+        }
+    }
+
+    // Optionally, report the resource usage of each test case.
+    unit_test_track_resources = false;
+
+    for (int n = 0; n < argc; n++)
+    {
+        if (0 == strcmp("--track-resources", argv[n]))
+        {
+            unit_test_track_resources = true;
+        }
+    }
+
+    // Optionally, measure the hardware performance counters of each test case.
+    unit_test_perf_enabled = false;
+
+    for (int n = 0; n < argc; n++)
+    {
+        if (0 == strcmp("--perf-counters", argv[n]))
+        {
+            unit_test_perf_enabled = true;
+        }
+    }
+
+    // Optionally, change the time budget of the benchmarks.
+    unit_test_bench_time_ns = UNIT_BENCH_DEFAULT_TIME_MS * 1000000LL;
+
+    for (int n = 0; n < argc - 1; n++)
+    {
+        if (0 == strcmp("--bench-time", argv[n]))
+        {
+            char* end = NULL;
+            long long value = strtoll(argv[n + 1], &end, 10);
+
+            if (end == argv[n + 1] || *end != '\0' || value <= 0)
+            {
+                printf("Invalid benchmark time: %s\n", argv[n + 1]);
+                return EXIT_FAILURE;
+            }
+
+            unit_test_bench_time_ns = (int64_t) value * 1000000LL;
+        }
+    }
+
+    // Optionally, change the number of rounds of the concurrent test cases.
+    unit_test_rounds = UNIT_TEST_DEFAULT_ROUNDS;
+
+    for (int n = 0; n < argc - 1; n++)
+    {
+        if (0 == strcmp("--rounds", argv[n]))
+        {
+            char* end = NULL;
+            long value = strtol(argv[n + 1], &end, 10);
+
+            if (end == argv[n + 1] || *end != '\0' || value < 1 || value > INT32_MAX / UNIT_TEST_MAX_THREADS)
+            {
+                printf("Invalid rounds: %s\n", argv[n + 1]);
+                return EXIT_FAILURE;
+            }
+
+            unit_test_rounds = (int32_t) value;
+        }
+    }
+
+    // Optionally, reproduce the inputs of the property-based test cases of a previous run.
+    // Otherwise, the seed differs per run, so that each run explores different inputs.
+    unit_test_seed = (uint64_t) unit_test_monotonic() ^ ((uint64_t) getpid() << 32);
+    unit_test_property_runs = UNIT_TEST_DEFAULT_PROPERTY_RUNS;
+    unit_test_property_time_ns = UNIT_TEST_DEFAULT_PROPERTY_TIME_MS * 1000000LL;
+
+    for (int n = 0; n < argc - 1; n++)
+    {
+        bool is_seed = 0 == strcmp("--seed", argv[n]);
+        bool is_runs = 0 == strcmp("--property-runs", argv[n]);
+        bool is_time = 0 == strcmp("--property-time", argv[n]);
+
+        if (is_seed || is_runs || is_time)
+        {
+            char* end = NULL;
+            unsigned long long value = strtoull(argv[n + 1], &end, 10);
+
+            if (end == argv[n + 1] || *end != '\0' || argv[n + 1][0] == '-' || (value == 0 && is_seed == false))
+            {
+                printf("Invalid %s: %s\n", is_seed ? "seed" : (is_runs ? "property runs" : "property time"), argv[n + 1]);
+                return EXIT_FAILURE;
+            }
+
+            unit_test_seed = is_seed ? (uint64_t) value : unit_test_seed;
+            unit_test_property_runs = is_runs ? (uint64_t) value : unit_test_property_runs;
+            unit_test_property_time_ns = is_time ? (int64_t) value * 1000000LL : unit_test_property_time_ns;
+        }
+    }
+
+    // Optionally, only execute a range of the rows of the table-driven test cases,
+    // such as in order to rerun only the rows that failed.
+    unit_test_first_row = 0;
+    unit_test_last_row = INT64_MAX;
+
+    for (int n = 0; n < argc - 1; n++)
+    {
+        if (0 == strcmp("--rows", argv[n]))
+        {
+            char* end = NULL;
+            long long first = strtoll(argv[n + 1], &end, 10);
+            long long last = first;
+
+            if (end != argv[n + 1] && *end == '-')
+            {
+                const char* rest = end + 1;
+                last = strtoll(rest, &end, 10);
+                end = (end == rest) ? (char*) argv[n + 1] : end;
+            }
+
+            if (end == argv[n + 1] || *end != '\0' || first < 0 || last < first)
+            {
+                printf("Invalid rows: %s\n", argv[n + 1]);
+                return EXIT_FAILURE;
+            }
+
+            unit_test_first_row = first;
+            unit_test_last_row = last;
+        }
+    }
+
+    // Optionally, summarize the slowest test cases.
+    int32_t slowest = 0;
+
+    for (int n = 0; n < argc - 1; n++)
+    {
+        if (0 == strcmp("--slowest", argv[n]))
+        {
+            char* end = NULL;
+            long value = strtol(argv[n + 1], &end, 10);
+
+            if (end == argv[n + 1] || *end != '\0' || value < 0 || value > INT32_MAX)
+            {
+                printf("Invalid number of slowest test cases: %s\n", argv[n + 1]);
+                return EXIT_FAILURE;
+            }
+
+            slowest = (int32_t) value;
+        }
+    }
+
+    // Optionally, save and/or compare the performance of the test cases.
+    const char* save_baseline_path = NULL;
+    const char* compare_baseline_path = NULL;
+    double max_regression_percent = UNIT_TEST_DEFAULT_MAX_REGRESSION;
+
+    unit_test_baseline_instructions = false;
+
+    for (int n = 0; n < argc - 1; n++)
+    {
+        if (0 == strcmp("--save-baseline", argv[n]))
+        {
+            save_baseline_path = argv[n + 1];
+        }
+        else if (0 == strcmp("--compare-baseline", argv[n]))
+        {
+            compare_baseline_path = argv[n + 1];
+        }
+        else if (0 == strcmp("--baseline-metric", argv[n]))
+        {
+            if (0 != strcmp("time", argv[n + 1]) && 0 != strcmp("instructions", argv[n + 1]))
+            {
+                printf("Invalid baseline metric: %s\n", argv[n + 1]);
+                return EXIT_FAILURE;
+            }
+
+            unit_test_baseline_instructions = 0 == strcmp("instructions", argv[n + 1]);
+        }
+        else if (0 == strcmp("--max-regression", argv[n]))
+        {
+            char* end = NULL;
+            max_regression_percent = strtod(argv[n + 1], &end);
+
+            if (end == argv[n + 1] || *end != '\0' || max_regression_percent < 0)
+            {
+                printf("Invalid maximum regression: %s\n", argv[n + 1]);
+                return EXIT_FAILURE;
+            }
+        }
+    }
+
+    // By default, run the test cases serially in this process.
+    int32_t jobs = 1;
+
+    for (int n = 0; n < argc - 1; n++)
+    {
+        if ((0 == strcmp("--jobs", argv[n])) || (0 == strcmp("-j", argv[n])))
+        {
+            char* end = NULL;
+            long value = strtol(argv[n + 1], &end, 10);
+
+            if (end == argv[n + 1] || *end != '\0' || value < 0 || value > 65536)
+            {
+                printf("Invalid number of jobs: %s\n", argv[n + 1]);
+                return EXIT_FAILURE;
+            }
+
+            jobs = value == 0 ? (int32_t) sysconf(_SC_NPROCESSORS_ONLN) : (int32_t) value;
+            jobs = jobs < 1 ? 1 : jobs;
+        }
+    }
+
+    // Optionally, capture the output of each test case, so that passing test cases are reported by a single line.
+    unit_test_capture = false;
+    unit_test_verbose = false;
+
+    for (int n = 0; n < argc; n++)
+    {
+        if (0 == strcmp("--capture", argv[n]))
+        {
+            unit_test_capture = true;
+        }
+        else if (0 == strcmp("--verbose", argv[n]))
+        {
+            unit_test_verbose = true;
+        }
+    }
+
+    // Optionally, overwrite what each test case allocated from the arena, in order to reveal uses thereof after the teardown.
+    unit_test_poison_arena = false;
+
+    for (int n = 0; n < argc; n++)
+    {
+        if (0 == strcmp("--poison-arena", argv[n]))
+        {
+            unit_test_poison_arena = true;
+        }
+    }
+
+    // Optionally, contain crashes and hangs by isolating each test case.
+    unit_test_isolate = false;
+    unit_test_timeout_ns = 0;
+
+    for (int n = 0; n < argc; n++)
+    {
+        if (0 == strcmp("--isolate", argv[n]))
+        {
+            unit_test_isolate = true;
+        }
+    }
+
+    for (int n = 0; n < argc - 1; n++)
+    {
+        if (0 == strcmp("--timeout", argv[n]))
+        {
+            char* end = NULL;
+            long long value = strtoll(argv[n + 1], &end, 10);
+
+            if (end == argv[n + 1] || *end != '\0' || value <= 0)
+            {
+                printf("Invalid timeout: %s\n", argv[n + 1]);
+                return EXIT_FAILURE;
+            }
+
+            // A hung test case can only be stopped by killing its process.
+            unit_test_isolate = true;
+            unit_test_timeout_ns = (int64_t) value * 1000000LL;
+        }
+    }
+
+    // Index the test cases, so that each of the following
+    // selections need not examine every test case.
+    unit_test_build_indexes();
+
+    // By default, the outcomes of the test cases are remembered in a state file next to the executable,
+    // so that the next run can execute only the failed test cases, or execute them first.
+    const char* state_path = NULL;
+    char default_state_path[4096];
+    bool rerun_failed = false;
+
+    unit_test_failed_first = false;
+
+    if (argc > 0 && snprintf(default_state_path, sizeof(default_state_path), "%s.state", argv[0]) < (int) sizeof(default_state_path))
+    {
+        state_path = default_state_path;
+    }
+
+    for (int n = 0; n < argc; n++)
+    {
+        if (0 == strcmp("--state-file", argv[n]) && n < argc - 1)
+        {
+            state_path = argv[n + 1];
+        }
+        else if (0 == strcmp("--rerun-failed", argv[n]))
+        {
+            rerun_failed = true;
+        }
+        else if (0 == strcmp("--failed-first", argv[n]))
+        {
+            unit_test_failed_first = true;
+        }
+    }
+
+    for (int n = 0; n < argc; n++)
+    {
+        if (0 == strcmp("--no-state", argv[n]))
+        {
+            state_path = NULL;
+        }
+    }
 
-    longjmp(unit_test_jump_point, 1);
-}
+    free(unit_test_history);
+    unit_test_history = NULL;
 
-/**
- * A private function used to implement the declaration of test cases.
- */
-void unit_test_declare (const char* suite,
-                        const char* name,
-                        unit_test_function_t function,
-                        unit_test_function_t setup,
-                        unit_test_function_t teardown)
-{
-    for (int32_t i = 0; i < UNIT_TEST_MAX_COUNT; i++)
+    if (state_path != NULL)
     {
-        if (unit_test_cases[i].allocated == false)
+        unit_test_history = calloc(unit_test_count + 1, sizeof(unit_test_history_t));
+
+        if (unit_test_history != NULL)
         {
-            unit_test_cases[i].allocated = true;
-            unit_test_cases[i].suite = suite;
-            unit_test_cases[i].name = name;
-            unit_test_cases[i].function = function;
-            unit_test_cases[i].setup = setup;
-            unit_test_cases[i].teardown = teardown;
-            return;
+            unit_test_load_state(state_path, unit_test_history);
         }
     }
-}
-
-/**
- * A private utility function used to obtain the monotonic current time.
- */
-static int64_t unit_test_monotonic ()
-{
-    struct timespec ts;
-    assert (clock_gettime(CLOCK_MONOTONIC, &ts) == 0);
-    return (int64_t) ts.tv_sec * (int64_t) 1000000000LL + (int64_t) ts.tv_nsec;
-}
 
-/**
- * Invoke this function in order to run the unit tests.
- */
-int unit_test_run (int argc, const char** argv)
-{
-    bool run_tests = false;
+    // Optionally, report the results in a structured format, such as for continuous integration servers.
+    const char* reporter_name = "text";
+    const char* output_path = NULL;
 
-    // Only execute unit tests, if the --test flag is given,
-    // because the caller may have compiled their program
-    // with unit-tests always present and also merely passed
-    // us their command-lines arguments; therefore, we want
-    // to make their life easier by only executing tests
-    // when it is clear that is the desired behavior.
-    for (int n = 0; n < argc; n++)
+    for (int n = 0; n < argc - 1; n++)
     {
-        if (0 == strcmp("--test", argv[n]))
+        if (0 == strcmp("--reporter", argv[n]))
         {
-            run_tests = true;
+            reporter_name = argv[n + 1];
+        }
+        else if (0 == strcmp("--output", argv[n]))
+        {
+            output_path = argv[n + 1];
         }
     }
 
-    if (run_tests == false)
+    const unit_test_reporter_t* reporter = unit_test_find_reporter(reporter_name);
+
+    if (reporter == NULL)
     {
+        printf("Unknown reporter: %s\n", reporter_name);
         return EXIT_FAILURE;
     }
 
-    // Print help.
+    // By default, the coverage map is next to the executable too. Collecting the coverage requires
+    // the program to be built with --coverage, while selecting the impacted test cases does not.
+    const char* coverage_path = NULL;
+    char default_coverage_path[4096];
+    const char* impacted_by = NULL;
+    bool collect_coverage = false;
+
+    if (argc > 0 && snprintf(default_coverage_path, sizeof(default_coverage_path), "%s.coverage", argv[0]) < (int) sizeof(default_coverage_path))
+    {
+        coverage_path = default_coverage_path;
+    }
+
     for (int n = 0; n < argc; n++)
     {
-        if ((0 == strcmp("--help", argv[n])) || (0 == strcmp("-h", argv[n])))
+        if (0 == strcmp("--coverage-map", argv[n]) && n < argc - 1)
         {
-            printf("Unit Test Help:\n");
-            printf("    --test:                        Activate the unit test runner.\n");
-            printf("    --all, -a:                     Enable all unit test suites and test cases.\n");
-            printf("    --enable-suite  <suite>:       Enable the named unit test suite.\n");
-            printf("    --disable-suite <suite>:       Disable the named unit test suite.\n");
-            printf("    --enable-case  <suite> <name>: Enable the named unit test case.\n");
-            printf("    --disable-case <suite> <name>: Disable the named unit test case.\n");
-            printf("    --help, -h:                    Print this help message.\n");
-            return EXIT_SUCCESS;
+            coverage_path = argv[n + 1];
+        }
+        else if (0 == strcmp("--impacted-by", argv[n]) && n < argc - 1)
+        {
+            impacted_by = argv[n + 1];
+        }
+        else if (0 == strcmp("--collect-coverage", argv[n]))
+        {
+            collect_coverage = true;
         }
     }
 
+    if ((collect_coverage || impacted_by != NULL) && coverage_path == NULL)
+    {
+        printf("The coverage map requires a path, such as via --coverage-map <file>.\n");
+        return EXIT_FAILURE;
+    }
+
+    if (collect_coverage && unit_test_gcov_reset() == false)
+    {
+        printf("Collecting the coverage requires defining UNIT_TEST_COVERAGE and building with --coverage.\n");
+        return EXIT_FAILURE;
+    }
+
     // By default, disable all test cases.
-    for (int i = 0; i < UNIT_TEST_MAX_COUNT && unit_test_cases[i].allocated; i++)
+    for (int32_t i = 0; i < unit_test_count; i++)
     {
-        unit_test_cases[i].enabled = false;
+        unit_test_hot[i].enabled = false;
     }
 
+    // Whether any test cases were explicitly selected.
+    bool selected = false;
+
     // Optionally, enable all test cases.
     for (int n = 0; n < argc; n++)
     {
         if ((0 == strcmp("--all", argv[n])) || (0 == strcmp("-a", argv[n])))
         {
-            for (int i = 0; i < UNIT_TEST_MAX_COUNT && unit_test_cases[i].allocated; i++)
+            selected = true;
+
+            for (int32_t i = 0; i < unit_test_count; i++)
             {
-                unit_test_cases[i].enabled = true;
+                unit_test_hot[i].enabled = true;
             }
         }
     }
@@ -181,175 +8788,433 @@ int unit_test_run (int argc, const char** argv)
     {
         if (0 == strcmp("--enable-suite", argv[n]))
         {
-            for (int i = 0; i < UNIT_TEST_MAX_COUNT && unit_test_cases[i].allocated; i++)
+            selected = true;
+
+            for (int32_t i = unit_test_find_suite(argv[n + 1]); i >= 0; i = unit_test_suite_index.next[i])
             {
-                bool suite_match = 0 == strcmp(unit_test_cases[i].suite, argv[n + 1]);
-                if (suite_match)
-                {
-                    unit_test_cases[i].enabled = true;
-                }
+                unit_test_hot[i].enabled = true;
             }
         }
     }
 
-
     // If tests are only being selectively enabled, enable the named test case.
     for (int n = 0; n < argc - 2; n++)
     {
         if (0 == strcmp("--enable-case", argv[n]))
         {
-            for (int i = 0; i < UNIT_TEST_MAX_COUNT && unit_test_cases[i].allocated; i++)
+            selected = true;
+
+            for (int32_t i = unit_test_find_case(argv[n + 1], argv[n + 2]); i >= 0; i = unit_test_case_index.next[i])
             {
-                bool suite_match = 0 == strcmp(unit_test_cases[i].suite, argv[n + 1]);
-                bool name_match = 0 == strcmp(unit_test_cases[i].name, argv[n + 2]);
-                bool match = suite_match && name_match;
-                if (match)
-                {
-                    unit_test_cases[i].enabled = true;
-                }
+                unit_test_hot[i].enabled = true;
             }
         }
     }
 
+    // If tests are only being selectively enabled, enable the test cases matching the glob.
+    for (int n = 0; n < argc - 1; n++)
+    {
+        if (0 == strcmp("--filter", argv[n]))
+        {
+            selected = true;
+            unit_test_apply_filter(argv[n + 1], true);
+        }
+    }
+
     // If tests are only being selectively enabled, disable the name test suite.
     for (int n = 0; n < argc - 1; n++)
     {
         if (0 == strcmp("--disable-suite", argv[n]))
         {
-            for (int i = 0; i < UNIT_TEST_MAX_COUNT && unit_test_cases[i].allocated; i++)
+            for (int32_t i = unit_test_find_suite(argv[n + 1]); i >= 0; i = unit_test_suite_index.next[i])
             {
-                bool suite_match = 0 == strcmp(unit_test_cases[i].suite, argv[n + 1]);
-                if (suite_match)
-                {
-                    unit_test_cases[i].enabled = false;
-                }
+                unit_test_hot[i].enabled = false;
             }
         }
     }
 
-
     // If tests are only being selectively enabled, disable the named test case.
     for (int n = 0; n < argc - 2; n++)
     {
         if (0 == strcmp("--disable-case", argv[n]))
         {
-            for (int i = 0; i < UNIT_TEST_MAX_COUNT && unit_test_cases[i].allocated; i++)
+            for (int32_t i = unit_test_find_case(argv[n + 1], argv[n + 2]); i >= 0; i = unit_test_case_index.next[i])
             {
-                bool suite_match = 0 == strcmp(unit_test_cases[i].suite, argv[n + 1]);
-                bool name_match = 0 == strcmp(unit_test_cases[i].name, argv[n + 2]);
-                bool match = suite_match && name_match;
-                if (match)
-                {
-                    unit_test_cases[i].enabled = false;
-                }
+                unit_test_hot[i].enabled = false;
             }
         }
     }
 
-    int passed = 0;
-    int failed = 0;
-    int64_t total_elapsed_time_mono_ns = 0;
+    // Optionally, only execute the selected test cases that failed during the previous run.
+    // If no test cases were selected, then consider all of the test cases.
+    if (rerun_failed)
+    {
+        for (int32_t i = 0; i < unit_test_count; i++)
+        {
+            unit_test_hot[i].enabled = (unit_test_hot[i].enabled || selected == false) && unit_test_previously_failed(i);
+        }
+
+        selected = true;
+    }
+
+    // Optionally, only execute the selected test cases that cover the changed files.
+    if (impacted_by != NULL)
+    {
+        unit_test_select_impacted(coverage_path, impacted_by, selected);
+        selected = true;
+    }
+
+    // When listing, if no test cases were selected, then list all of the test cases.
+    bool list = false;
 
-    for (int i = 0; i < UNIT_TEST_MAX_COUNT && unit_test_cases[i].allocated; i++)
+    for (int n = 0; n < argc; n++)
     {
-        if (unit_test_cases[i].enabled == false)
+        if (0 == strcmp("--list", argv[n]))
         {
-            continue; // skip disabled test suites and/or test cases
+            list = true;
         }
+    }
 
-        unit_test_current = i;
+    for (int32_t i = 0; list && selected == false && i < unit_test_count; i++)
+    {
+        unit_test_hot[i].enabled = true;
+    }
 
-        printf("----------------------------- TEST CASE -----------------------------\n");
-        printf("Suite: %s\n", unit_test_cases[i].suite);
-        printf("Name: %s\n", unit_test_cases[i].name);
+    // Optionally, only execute the test cases assigned to one of several shards,
+    // so that the test cases can be split across multiple machines.
+    int32_t shard_index = -1;
+    int32_t shard_count = 0;
+    const char* shard_timings_path = NULL;
 
-        unit_test_cases[i].result.passed = true;
-        unit_test_cases[i].result.end_time_mono_ns = 0;
-        unit_test_cases[i].result.elapsed_time_mono_ns = 0;
-        unit_test_cases[i].result.start_time_mono_ns = unit_test_monotonic();
+    for (int n = 0; n < argc - 1; n++)
+    {
+        bool is_index = 0 == strcmp("--shard-index", argv[n]);
+        bool is_count = 0 == strcmp("--shard-count", argv[n]);
 
-        // Execute the setup function, if any,
-        // which may contain assertions too.
-        if (setjmp(unit_test_jump_point))
+        if (is_index || is_count)
         {
-            // Pass. Return point of an assertion jump.
-            unit_test_get_cases()[i].result.passed = false;
+            char* end = NULL;
+            long value = strtol(argv[n + 1], &end, 10);
+
+            if (end == argv[n + 1] || *end != '\0' || value < (is_index ? 0 : 1) || value > 65536)
+            {
+                printf("Invalid %s: %s\n", is_index ? "shard index" : "shard count", argv[n + 1]);
+                return EXIT_FAILURE;
+            }
+
+            shard_index = is_index ? (int32_t) value : shard_index;
+            shard_count = is_count ? (int32_t) value : shard_count;
         }
-        else if (NULL != unit_test_cases[i].setup)
+        else if (0 == strcmp("--shard-timings", argv[n]))
         {
-            unit_test_cases[i].setup();
+            shard_timings_path = argv[n + 1];
         }
+    }
+
+    if (shard_index >= 0 && shard_index >= shard_count)
+    {
+        printf("The shard index must be less than the shard count.\n");
+        return EXIT_FAILURE;
+    }
+
+    // Otherwise, a node that was given no index, such as due to a typo, would execute every shard.
+    if (shard_count > 0 && shard_index < 0 && list == false)
+    {
+        printf("The shard count requires a shard index, unless listing the shards via --list.\n");
+        return EXIT_FAILURE;
+    }
+
+    if (shard_count > 0)
+    {
+        unit_test_baseline_t* timings = NULL;
+        int32_t* shards = malloc(sizeof(int32_t) * (unit_test_count + 1));
+        double* loads = malloc(sizeof(double) * shard_count);
+        bool planned = false;
 
-        // If the setup function was successful,
-        // then execute the unit-test case itself.
-        if (unit_test_get_cases()[i].result.passed)
+        if (shard_timings_path != NULL)
         {
-            if (setjmp(unit_test_jump_point))
+            timings = calloc(unit_test_count + 1, sizeof(unit_test_baseline_t));
+
+            if (timings == NULL || unit_test_load_baseline(shard_timings_path, timings) == false)
             {
-                // Pass. Return point of an assertion jump.
-                unit_test_get_cases()[i].result.passed = false;
+                printf("Unable to read the shard timings: %s\n", shard_timings_path);
+                free(timings);
+                free(shards);
+                free(loads);
+                return EXIT_FAILURE;
             }
-            else
+        }
+
+        if (shards != NULL && loads != NULL)
+        {
+            planned = unit_test_plan_shards(shard_count, timings, shards, loads);
+        }
+
+        if (planned && list && shard_index < 0)
+        {
+            // A dry run, which shows the assignment of every shard.
+            unit_test_print_shards(shard_count, shards, loads, timings != NULL);
+        }
+
+        for (int32_t i = 0; planned && i < unit_test_count; i++)
+        {
+            unit_test_hot[i].enabled = unit_test_hot[i].enabled && (shard_index < 0 || shards[i] == shard_index);
+        }
+
+        free(timings);
+        free(shards);
+        free(loads);
+
+        if (planned == false)
+        {
+            printf("Unable to assign the test cases to shards, due to insufficient memory.\n");
+            return EXIT_FAILURE;
+        }
+
+        if (list && shard_index < 0)
+        {
+            return EXIT_SUCCESS;
+        }
+    }
+
+    // Optionally, list the selected test cases, rather than executing them.
+    if (list)
+    {
+        for (int32_t i = 0; i < unit_test_count; i++)
+        {
+            if (unit_test_hot[i].enabled)
             {
-                unit_test_cases[i].function();
+                printf("%s/%s\n", unit_test_cases[i].suite, unit_test_cases[i].name);
             }
         }
 
-        // Always execute the teardown function, if any,
-        // which may contain assertions too.
-        if (setjmp(unit_test_jump_point))
+        return EXIT_SUCCESS;
+    }
+
+    // Load the baseline before executing anything, so that a bad path fails fast.
+    unit_test_baseline_t* baselines = NULL;
+
+    if (compare_baseline_path != NULL)
+    {
+        baselines = calloc(unit_test_count + 1, sizeof(unit_test_baseline_t));
+
+        if (baselines == NULL || unit_test_load_baseline(compare_baseline_path, baselines) == false)
         {
-            // Pass. Return point of an assertion jump.
-            unit_test_get_cases()[i].result.passed = false;
+            printf("Unable to read the baseline: %s\n", compare_baseline_path);
+            free(baselines);
+            return EXIT_FAILURE;
         }
-        else if (NULL != unit_test_cases[i].teardown)
+    }
+
+    // Each process that executes test cases appends the coverage thereof to this file,
+    // which is merged into the coverage map at the end.
+    char recorded_coverage_path[4096];
+
+    if (collect_coverage && snprintf(recorded_coverage_path, sizeof(recorded_coverage_path), "%s.new", coverage_path) < (int) sizeof(recorded_coverage_path))
+    {
+        unit_test_coverage_fd = open(recorded_coverage_path, O_WRONLY | O_CREAT | O_TRUNC | O_APPEND | O_CLOEXEC, 0644);
+    }
+
+    if (collect_coverage && unit_test_coverage_fd < 0)
+    {
+        printf("Unable to write the coverage map: %s\n", coverage_path);
+        free(baselines);
+        return EXIT_FAILURE;
+    }
+
+    int saved_stdout = -1;
+
+    if (unit_test_open_report(reporter, 0 == strcmp(reporter_name, "text"), output_path, &saved_stdout) == false)
+    {
+        printf("Unable to write the report: %s\n", output_path);
+        free(baselines);
+        return EXIT_FAILURE;
+    }
+
+    // Optionally, record a timeline of the test cases, fixtures, and phases thereof.
+    const char* trace_path = NULL;
+
+    for (int n = 0; n < argc - 1; n++)
+    {
+        if (0 == strcmp("--trace", argv[n]))
+        {
+            trace_path = argv[n + 1];
+        }
+    }
+
+    if (trace_path != NULL && unit_test_open_trace() == false)
+    {
+        printf("Unable to create the trace buffer, so not tracing.\n");
+        trace_path = NULL;
+    }
+
+    if (unit_test_reporter != NULL && unit_test_reporter->start_run != NULL)
+    {
+        int32_t enabled = 0;
+
+        for (int32_t i = 0; i < unit_test_count; i++)
+        {
+            enabled += unit_test_hot[i].enabled ? 1 : 0;
+        }
+
+        unit_test_reporter->start_run(unit_test_report_output, enabled);
+    }
+
+    int64_t start_time_mono_ns = unit_test_monotonic();
+
+    // Execute the global setup function, if any, exactly once,
+    // so that isolated test cases and workers, which are forked
+    // from this process, inherit the already initialized state.
+    bool global_setup_passed = unit_test_resident || unit_test_invoke_fixture(unit_test_global_setup, NULL, "setup");
+    bool suites_passed = true;
+
+    if (global_setup_passed == false)
+    {
+        printf("The global setup failed, so the test cases were not executed.\n\n");
+
+        for (int32_t i = 0; i < unit_test_count; i++)
         {
-            unit_test_cases[i].teardown();
+            memset(&unit_test_cases[i].result, 0, sizeof(unit_test_case_result_t));
+
+            if (unit_test_hot[i].enabled)
+            {
+                unit_test_report_start(i);
+                unit_test_report_end(i);
+            }
         }
+    }
+    else if (jobs > 1)
+    {
+        suites_passed = unit_test_run_parallel(jobs);
+    }
+    else
+    {
+        suites_passed = unit_test_run_serial();
+    }
+
+    // Always execute the global teardown function, if any.
+    bool global_teardown_passed = unit_test_resident || unit_test_invoke_fixture(unit_test_global_teardown, NULL, "teardown");
+
+    if (global_teardown_passed == false)
+    {
+        printf("The global teardown failed.\n\n");
+    }
+
+    if (trace_path != NULL && unit_test_save_trace(trace_path) == false)
+    {
+        printf("Unable to write the trace: %s\n", trace_path);
+    }
 
-        unit_test_cases[i].result.end_time_mono_ns = unit_test_monotonic();
-        unit_test_cases[i].result.elapsed_time_mono_ns = unit_test_cases[i].result.end_time_mono_ns - unit_test_cases[i].result.start_time_mono_ns;
+    // Release what the global fixtures allocated from the arena, unless they stay alive between runs.
+    if (unit_test_resident == false)
+    {
+        unit_test_arena_mark_t empty = { NULL, 0 };
+        unit_test_reset_arena(empty);
+    }
 
-        total_elapsed_time_mono_ns += unit_test_cases[i].result.elapsed_time_mono_ns;
+    int64_t wall_time_mono_ns = unit_test_monotonic() - start_time_mono_ns;
 
-        bool ok = unit_test_cases[i].result.passed;
+    unit_test_run_summary_t summary;
+    memset(&summary, 0, sizeof(summary));
+    summary.wall_time_mono_ns = wall_time_mono_ns;
+    summary.jobs = jobs;
+
+    for (int32_t i = 0; i < unit_test_count; i++)
+    {
+        if (unit_test_hot[i].enabled == false)
+        {
+            continue; // skip disabled test suites and/or test cases
+        }
 
-        printf("Elapsed Time: %.4f seconds\n", ((double) unit_test_cases[i].result.elapsed_time_mono_ns) / 1e9);
+        summary.elapsed_time_mono_ns += unit_test_cases[i].result.elapsed_time_mono_ns;
+        summary.cpu_time_ns += unit_test_cases[i].result.cpu_time_ns;
 
-        if (ok)
+        if (unit_test_cases[i].result.passed)
         {
-            ++passed;
-            printf("Result: PASS\n");
+            ++summary.passed;
         }
         else
         {
-            ++failed;
-            printf("Result: FAIL\n");
+            ++summary.failed;
         }
+    }
 
-        printf("--------------------------- END TEST CASE ---------------------------\n");
-        printf("\n");
-        printf("\n");
+    if (slowest > 0)
+    {
+        unit_test_report_slowest(slowest);
+    }
+
+    int32_t regressions = 0;
+
+    if (baselines != NULL)
+    {
+        regressions = unit_test_report_baseline(baselines, max_regression_percent);
+        free(baselines);
+    }
+
+    // Save the baseline, while retaining the entries for test cases that were not executed.
+    if (save_baseline_path != NULL)
+    {
+        unit_test_baseline_t* saved = calloc(unit_test_count + 1, sizeof(unit_test_baseline_t));
+
+        if (saved != NULL)
+        {
+            unit_test_load_baseline(save_baseline_path, saved);
+
+            for (int32_t i = 0; i < unit_test_count; i++)
+            {
+                if (unit_test_hot[i].enabled && unit_test_cases[i].result.passed)
+                {
+                    saved[i] = unit_test_measure(i);
+                }
+            }
+        }
+
+        if (saved == NULL || unit_test_save_baseline(save_baseline_path, saved) == false)
+        {
+            printf("Unable to write the baseline: %s\n", save_baseline_path);
+            regressions = regressions == 0 ? 1 : regressions;
+        }
+
+        free(saved);
     }
 
-    int total = passed + failed;
+    // Remember the outcomes of the test cases for the next run.
+    if (state_path != NULL && unit_test_history != NULL && unit_test_save_state(state_path, unit_test_history) == false)
+    {
+        printf("Unable to write the state file: %s\n", state_path);
+    }
 
-    printf("-------------------------- RESULTS SUMMARY --------------------------\n");
-    printf("Passed Tests: %d\n", passed);
-    printf("Failed Tests: %d\n", failed);
-    printf("Total  Tests: %d\n", total);
-    printf("Elapsed Time: %.4f seconds\n", ((double) total_elapsed_time_mono_ns) / 1e9);
+    free(unit_test_history);
+    unit_test_history = NULL;
 
-    if (passed == total)
+    // Merge the coverage of the executed test cases into the coverage map.
+    if (unit_test_coverage_fd >= 0)
     {
-        printf("------------------------------ PASSED -------------------------------\n");
-        return EXIT_SUCCESS;
+        close(unit_test_coverage_fd);
+        unit_test_coverage_fd = -1;
+
+        if (unit_test_save_coverage(coverage_path, recorded_coverage_path) == false)
+        {
+            printf("Unable to write the coverage map: %s\n", coverage_path);
+        }
     }
-    else
+
+    bool passed = summary.failed == 0 && regressions == 0 && global_setup_passed && global_teardown_passed && suites_passed;
+    summary.succeeded = passed;
+
+    if (unit_test_reporter != NULL && unit_test_reporter->end_run != NULL)
     {
-        printf("------------------------------ FAILED -------------------------------\n");
-        return EXIT_FAILURE;
+        unit_test_reporter->end_run(unit_test_report_output, &summary);
     }
+
+    if (unit_test_close_report(saved_stdout) == false)
+    {
+        fprintf(stderr, "Unable to write the report: %s\n", output_path != NULL ? output_path : "<stdout>");
+        passed = false;
+    }
+
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
 }
 
 #endif // SKIP_UNIT_TESTS
@@ -37,12 +37,206 @@
 #include <setjmp.h>
 #include <time.h>
 
-#define UNIT_TEST_MAX_COUNT 65536
+// The table of test cases initially holds this many test cases and then grows geometrically.
+#define UNIT_TEST_CHUNK_COUNT 256
 
 #define UNIT_TEST_CASE_WITH(SUITE, FUNCTION, SETUP, TEARDOWN) unit_test_declare(#SUITE, #FUNCTION, FUNCTION, SETUP, TEARDOWN);
 
 #define UNIT_TEST_CASE(SUITE, FUNCTION) unit_test_declare(#SUITE, #FUNCTION, FUNCTION, NULL, NULL);
 
+// These declare a test case, which runs against the virtual clock, such that sleeping advances the clock at once.
+#define UNIT_TEST_VIRTUAL_CASE_WITH(SUITE, FUNCTION, SETUP, TEARDOWN) unit_test_declare_virtual(#SUITE, #FUNCTION, FUNCTION, SETUP, TEARDOWN);
+
+#define UNIT_TEST_VIRTUAL_CASE(SUITE, FUNCTION) unit_test_declare_virtual(#SUITE, #FUNCTION, FUNCTION, NULL, NULL);
+
+#define UNIT_BENCH_CASE_WITH(SUITE, FUNCTION, SETUP, TEARDOWN) unit_test_declare_bench(#SUITE, #FUNCTION, FUNCTION, SETUP, TEARDOWN);
+
+#define UNIT_BENCH_CASE(SUITE, FUNCTION) unit_test_declare_bench(#SUITE, #FUNCTION, FUNCTION, NULL, NULL);
+
+// These define a test case, which registers itself, without a call to UNIT_TEST_CASE. For example:
+//
+//     UNIT_TEST (ExampleSuite, test_basecase_0)
+//     {
+//         assertEqual(0, fib(0));
+//     }
+//
+// On ELF platforms, the descriptor of the test case is placed in a section of its own,
+// so that the linker builds the table of test cases, and nothing is executed at startup.
+// Elsewhere, the test case is declared by a constructor function instead.
+#ifdef __ELF__
+#define UNIT_TEST_REGISTER(SUITE, FUNCTION, SETUP, TEARDOWN, KIND) \
+    static void FUNCTION (); \
+    __attribute__((used, section("unit_test_cases"), aligned(sizeof(void*)))) \
+    static const unit_test_descriptor_t unit_test_descriptor_##SUITE##_##FUNCTION = { #SUITE, #FUNCTION, FUNCTION, SETUP, TEARDOWN, KIND, __FILE__, __LINE__ }; \
+    static void FUNCTION ()
+#else
+#define UNIT_TEST_REGISTER(SUITE, FUNCTION, SETUP, TEARDOWN, KIND) \
+    static void FUNCTION (); \
+    __attribute__((constructor)) static void unit_test_register_##SUITE##_##FUNCTION () \
+    { \
+        (KIND) == UNIT_TEST_KIND_BENCH ? unit_test_declare_bench(#SUITE, #FUNCTION, FUNCTION, SETUP, TEARDOWN) \
+                                       : unit_test_declare(#SUITE, #FUNCTION, FUNCTION, SETUP, TEARDOWN); \
+    } \
+    static void FUNCTION ()
+#endif
+
+#define UNIT_TEST(SUITE, FUNCTION) UNIT_TEST_REGISTER(SUITE, FUNCTION, NULL, NULL, UNIT_TEST_KIND_TEST)
+
+#define UNIT_TEST_WITH(SUITE, FUNCTION, SETUP, TEARDOWN) UNIT_TEST_REGISTER(SUITE, FUNCTION, SETUP, TEARDOWN, UNIT_TEST_KIND_TEST)
+
+#define UNIT_BENCH(SUITE, FUNCTION) UNIT_TEST_REGISTER(SUITE, FUNCTION, NULL, NULL, UNIT_TEST_KIND_BENCH)
+
+#define UNIT_TEST_TABLE(SUITE, FUNCTION, ARRAY) unit_test_declare_table(#SUITE, #FUNCTION, FUNCTION, (ARRAY), sizeof(ARRAY) / sizeof((ARRAY)[0]), sizeof((ARRAY)[0]));
+
+// A relative PATH is relative to the directory of the source file that declares the test case.
+#define UNIT_TEST_DATA_FILE(SUITE, FUNCTION, PATH) unit_test_declare_data_file(#SUITE, #FUNCTION, FUNCTION, (PATH), __FILE__);
+
+#define UNIT_TEST_PROPERTY(SUITE, FUNCTION, ...) unit_test_declare_property(#SUITE, #FUNCTION, FUNCTION, (const unit_test_generator_t[]) { __VA_ARGS__ }, sizeof((const unit_test_generator_t[]) { __VA_ARGS__ }) / sizeof(unit_test_generator_t));
+
+// These describe the inputs of a property, which are generated anew for each run thereof.
+#define UNIT_GEN_INT(MIN, MAX) ((unit_test_generator_t) { UNIT_TEST_GENERATOR_INTEGER, (MIN), (MAX) })
+#define UNIT_GEN_BYTES(MIN_LENGTH, MAX_LENGTH) ((unit_test_generator_t) { UNIT_TEST_GENERATOR_BYTES, (MIN_LENGTH), (MAX_LENGTH) })
+#define UNIT_GEN_STRING(MIN_LENGTH, MAX_LENGTH) ((unit_test_generator_t) { UNIT_TEST_GENERATOR_STRING, (MIN_LENGTH), (MAX_LENGTH) })
+
+#define UNIT_TEST_CONCURRENT(SUITE, FUNCTION, THREADS) unit_test_declare_concurrent(#SUITE, #FUNCTION, FUNCTION, (THREADS));
+
+#define UNIT_TEST_COMPLEXITY(SUITE, FUNCTION, MIN_N, MAX_N) unit_test_declare_complexity(#SUITE, #FUNCTION, FUNCTION, (MIN_N), (MAX_N));
+
+#define UNIT_TEST_GLOBAL_WITH(SETUP, TEARDOWN) unit_test_declare_global(SETUP, TEARDOWN);
+
+#define UNIT_TEST_SUITE_WITH(SUITE, SETUP, TEARDOWN) unit_test_declare_suite(#SUITE, SETUP, TEARDOWN);
+
+// Records a span, which is named by the given string constant, from here to the end of the enclosing block, given --trace.
+// For example:
+//
+//     static void test_parser ()
+//     {
+//         UNIT_TRACE_SCOPE("parse");
+//         parse(input);
+//     }
+//
+// The span is not recorded, if an assertion fails within the block, since the assertion jumps out of the block.
+#define UNIT_TRACE_SCOPE(NAME) \
+    unit_test_trace_scope_t UNIT_TEST_CONCAT(unit_trace_scope_, __LINE__) __attribute__((cleanup(unit_test_end_trace_scope))) = unit_test_begin_trace_scope(NAME)
+
+#define UNIT_TEST_CONCAT(LEFT, RIGHT) UNIT_TEST_CONCAT_EXPANDED(LEFT, RIGHT)
+#define UNIT_TEST_CONCAT_EXPANDED(LEFT, RIGHT) LEFT##RIGHT
+
+// The default time budget of a benchmark, which may be overridden via --bench-time.
+#define UNIT_BENCH_DEFAULT_TIME_MS 200
+
+// The maximum number of timed samples that a benchmark collects.
+#define UNIT_BENCH_MAX_SAMPLES 1024
+
+// Prevents the compiler from optimizing away the computation of a value,
+// whose result would otherwise be unused in the body of a benchmark,
+// by pretending that the value is read by an opaque assembly statement.
+#define UNIT_BENCH_DO_NOT_OPTIMIZE(VALUE) do { __typeof__(VALUE) unit_bench_value_ = (VALUE); __asm__ __volatile__ ("" : : "r,m" (unit_bench_value_) : "memory"); } while (0)
+
+// Prevents the compiler from assuming that memory is unchanged across this point,
+// so that stores, which would otherwise be dead, are actually performed.
+#define UNIT_BENCH_CLOBBER() __asm__ __volatile__ ("" : : : "memory")
+
+// The default maximum slowdown, as a percentage, before a case is considered to have regressed.
+#define UNIT_TEST_DEFAULT_MAX_REGRESSION 10.0
+
+// A change in the median time of a benchmark must exceed this multiple of the MAD to be significant.
+#define UNIT_TEST_BASELINE_NOISE_FACTOR 3.0
+
+// A change in the time of a test case, which was only measured once, must exceed this to be significant.
+#define UNIT_TEST_BASELINE_NOISE_FLOOR_NS 100000.0
+
+// The maximum length of a row in a data file, which is copied, so that it can be NUL-terminated.
+#define UNIT_TEST_MAX_ROW_SIZE 4096
+
+// The maximum number of failed rows of a table-driven test case, which are reported in detail.
+#define UNIT_TEST_MAX_REPORTED_ROWS 10
+
+// The maximum number of bytes of a row of a static array, which are reported as the values thereof.
+#define UNIT_TEST_MAX_REPORTED_ROW_BYTES 32
+
+// The default number of times that a property is run, which may be overridden via --property-runs.
+#define UNIT_TEST_DEFAULT_PROPERTY_RUNS 1000
+
+// The default time budget of a property, which may be overridden via --property-time.
+#define UNIT_TEST_DEFAULT_PROPERTY_TIME_MS 1000
+
+// The maximum number of inputs of a property.
+#define UNIT_TEST_MAX_GENERATORS 8
+
+// The maximum length of a generated byte buffer or string.
+#define UNIT_TEST_MAX_GENERATED_SIZE 4096
+
+// The maximum number of attempts to shrink the counterexample of a property.
+#define UNIT_TEST_MAX_SHRINK_STEPS 10000
+
+// The default number of rounds of a concurrent test case, which may be overridden via --rounds.
+#define UNIT_TEST_DEFAULT_ROUNDS 100
+
+// The maximum number of threads of a concurrent test case.
+#define UNIT_TEST_MAX_THREADS 1024
+
+// The maximum number of mismatches between two buffers, around which a hexdump is printed.
+#define UNIT_TEST_MAX_REPORTED_MISMATCHES 3
+
+// The number of hexdump lines, of sixteen bytes each, printed per mismatch.
+#define UNIT_TEST_HEXDUMP_LINES 2
+
+// The maximum number of input sizes of a complexity test case, which are successive powers of two.
+#define UNIT_TEST_MAX_COMPLEXITY_SIZES 40
+
+// The number of samples of each input size of a complexity test case, of which the fastest is used.
+#define UNIT_TEST_COMPLEXITY_SAMPLES 5
+
+// The minimum duration of a sample of a complexity test case, which is calibrated by batching calls.
+#define UNIT_TEST_COMPLEXITY_MIN_SAMPLE_NS 100000
+
+// A worse growth model is only fitted, if the relative error thereof is less than this fraction of that of a better one.
+#define UNIT_TEST_COMPLEXITY_PREFERENCE 0.9
+
+// The number of times that the sizes of a complexity test case are measured, before the test case fails,
+// if the growth is worse than the bound thereof, or the fit is inconclusive, since preemption can inflate the cost of any one size.
+#define UNIT_TEST_COMPLEXITY_ATTEMPTS 3
+
+// A fit whose root mean square relative error exceeds this fraction is inconclusive, so the sizes are measured again.
+#define UNIT_TEST_COMPLEXITY_MAX_RMS 0.25
+
+// The magic numbers of the notes (.gcno) and data (.gcda) files of gcov, and the tags of the records therein.
+#define UNIT_TEST_GCNO_MAGIC 0x67636e6fU
+#define UNIT_TEST_GCDA_MAGIC 0x67636461U
+#define UNIT_TEST_GCOV_TAG_FUNCTION 0x01000000U
+#define UNIT_TEST_GCOV_TAG_ARCS 0x01a10000U
+#define UNIT_TEST_GCOV_TAG_LINES 0x01450000U
+
+// The maximum number of test modules (shared objects) that can be loaded via --module.
+#define UNIT_TEST_MAX_MODULES 64
+
+// The maximum number of words in a command of the resident test runner.
+#define UNIT_TEST_MAX_COMMAND_WORDS 256
+
+// The maximum length of a build ID, in hexadecimal digits.
+#define UNIT_TEST_BUILD_ID_SIZE 64
+
+// The maximum length of the file name and the message of the first failure of a test case, which are recorded for reporters.
+#define UNIT_TEST_MAX_FAILURE_FILE 256
+#define UNIT_TEST_MAX_FAILURE_MESSAGE 512
+
+// The maximum number of reporters, including the built-in ones.
+#define UNIT_TEST_MAX_REPORTERS 16
+
+// The size of the buffer of the output of a reporter, which is written in large blocks.
+#define UNIT_TEST_OUTPUT_BUFFER_SIZE (1 << 20)
+
+// The size of each chunk of the arena of the test cases, unless an allocation is larger, and the alignment of the allocations therein.
+#define UNIT_TEST_ARENA_CHUNK_SIZE (1 << 20)
+#define UNIT_TEST_ARENA_ALIGNMENT 16
+
+// The byte that overwrites the allocations of the arena, when it is reset, given --poison-arena.
+#define UNIT_TEST_ARENA_POISON 0xDB
+
+// The number of spans that the trace buffer holds, which is a power of two, beyond which the oldest spans are overwritten.
+#define UNIT_TEST_TRACE_CAPACITY (1 << 16)
+
 // The varadic arguments to the macro will be passed to printf().
 // Creating a varadic printf() call is difficult, when the arity can be zero too.
 // Therefore, this macro must play a little bit of a trick.
@@ -78,13 +272,45 @@
 #define assertNull(VALUE, ...) assertTrue(NULL == (VALUE), ## __VA_ARGS__)
 #define assertNotNull(VALUE, ...) assertTrue(NULL != (VALUE), ## __VA_ARGS__)
 
-#define assertStrEqual(EXPECTED, ACTUAL, ...) assertEqual(0, strcmp((EXPECTED), (ACTUAL)), ## __VA_ARGS__)
+// These assertions report where and how the strings or buffers differ, if they do.
+// The passing path is merely a strcmp() or memcmp(), so even huge buffers are cheap to compare.
+#define UNIT_TEST_FAIL_MISMATCH(EXPECTED, EXPECTED_LENGTH, ACTUAL, ACTUAL_LENGTH, ...) \
+    unit_test_fail_mismatch(__FILE__, __LINE__, (EXPECTED), (EXPECTED_LENGTH), (ACTUAL), (ACTUAL_LENGTH), 0 != strnlen(#__VA_ARGS__, 3), ##__VA_ARGS__)
+
+#define assertStrEqual(EXPECTED, ACTUAL, ...) do { \
+    const char* unit_expected_ = (EXPECTED); const char* unit_actual_ = (ACTUAL); \
+    if (0 != strcmp(unit_expected_, unit_actual_)) { \
+        UNIT_TEST_FAIL_MISMATCH(unit_expected_, strlen(unit_expected_), unit_actual_, strlen(unit_actual_), ##__VA_ARGS__); } } while (0)
 #define assertStrNotEqual(EXPECTED, ACTUAL, ...) assertNotEqual(0, strcmp((EXPECTED), (ACTUAL)), ## __VA_ARGS__)
 
-#define assertStrnEqual(EXPECTED, ACTUAL, LENGTH, ...) assertEqual(0, strcmp((EXPECTED), (ACTUAL), (LENGTH)), ## __VA_ARGS__)
-#define assertStrnNotEqual(EXPECTED, ACTUAL, LENGTH, ...) assertNotEqual(0, strcmp((EXPECTED), (ACTUAL), (LENGTH)), ## __VA_ARGS__)
+#define assertStrnEqual(EXPECTED, ACTUAL, LENGTH, ...) do { \
+    const char* unit_expected_ = (EXPECTED); const char* unit_actual_ = (ACTUAL); size_t unit_length_ = (LENGTH); \
+    if (0 != strncmp(unit_expected_, unit_actual_, unit_length_)) { \
+        UNIT_TEST_FAIL_MISMATCH(unit_expected_, strnlen(unit_expected_, unit_length_), unit_actual_, strnlen(unit_actual_, unit_length_), ##__VA_ARGS__); } } while (0)
+#define assertStrnNotEqual(EXPECTED, ACTUAL, LENGTH, ...) assertNotEqual(0, strncmp((EXPECTED), (ACTUAL), (LENGTH)), ## __VA_ARGS__)
+
+// This assertion declares the worst acceptable growth of a complexity test case, when invoked from the function thereof.
+// The test case fails, once every input size has been measured, if the growth that best fits the measurements is worse.
+#define assertComplexityAtMost(BOUND) unit_test_bound_complexity(__FILE__, __LINE__, (BOUND));
+
+// These assertions require that malloc() is interposed, which is only done with glibc, if UNIT_TEST_INTERPOSE is defined,
+// and fail otherwise. If the allocations are not being counted, since --track-resources was not given,
+// then the test case is executed again, while counting them.
+#define assertAllocationsAtMost(COUNT, ...) assertTrue(unit_test_check_allocations(__FILE__, __LINE__)->allocations <= (uint64_t) (COUNT), ## __VA_ARGS__)
+#define assertAllocatedBytesAtMost(BYTES, ...) assertTrue(unit_test_check_allocations(__FILE__, __LINE__)->allocated_bytes <= (uint64_t) (BYTES), ## __VA_ARGS__)
+#define assertNoAllocations(...) assertAllocationsAtMost(0, ## __VA_ARGS__)
+#define assertNoLeaks(...) assertTrue(unit_test_check_allocations(__FILE__, __LINE__)->leaked_bytes <= 0, ## __VA_ARGS__)
 
-#define assertMemEqual(EXPECTED, ACTUAL, LENGTH, ...) assertEqual(0, memcmp((EXPECTED), (ACTUAL), (LENGTH)), ## __VA_ARGS__)
+#define assertMemEqual(EXPECTED, ACTUAL, LENGTH, ...) do { \
+    const void* unit_expected_ = (EXPECTED); const void* unit_actual_ = (ACTUAL); size_t unit_length_ = (LENGTH); \
+    if (0 != memcmp(unit_expected_, unit_actual_, unit_length_)) { \
+        UNIT_TEST_FAIL_MISMATCH(unit_expected_, unit_length_, unit_actual_, unit_length_, ##__VA_ARGS__); } } while (0)
+
+#define assertBufferEqual(EXPECTED, EXPECTED_LENGTH, ACTUAL, ACTUAL_LENGTH, ...) do { \
+    const void* unit_expected_ = (EXPECTED); const void* unit_actual_ = (ACTUAL); \
+    size_t unit_expected_length_ = (EXPECTED_LENGTH); size_t unit_actual_length_ = (ACTUAL_LENGTH); \
+    if (unit_expected_length_ != unit_actual_length_ || 0 != memcmp(unit_expected_, unit_actual_, unit_expected_length_)) { \
+        UNIT_TEST_FAIL_MISMATCH(unit_expected_, unit_expected_length_, unit_actual_, unit_actual_length_, ##__VA_ARGS__); } } while (0)
 #define assertMemNotEqual(EXPECTED, ACTUAL, LENGTH, ...) assertNotEqual(0, memcmp((EXPECTED), (ACTUAL), (LENGTH)), ## __VA_ARGS__)
 
 /**
@@ -93,99 +319,1018 @@
 typedef void (*unit_test_function_t)();
 
 /**
- * The results of running a single unit test case.
+ * A row of a table-driven test case.
  */
 typedef struct
 {
     /**
-     * True, if the test case passed and did not fail.
+     * The zero-based index of the row within the table or data file.
      */
-    bool passed;
+    int64_t index;
 
     /**
-     * Monotonic time of when the test case began execution.
+     * The element of the static array, or the NUL-terminated text of the line in the data file.
      */
-    time_t start_time_mono_ns;
+    const void* data;
 
     /**
-     * Monotonic time of when the test case finished execution.
+     * The size of the element of the static array, or the length of the line in the data file.
+     */
+    size_t size;
+
+} unit_test_row_t;
+
+/**
+ * Signature of a table-driven test case function, which is invoked once per row.
+ */
+typedef void (*unit_test_row_function_t)(const unit_test_row_t* row);
+
+/**
+ * The kinds of inputs that can be generated for a property.
+ */
+typedef enum
+{
+    /**
+     * An integer in the range [min, max].
      */
-    time_t end_time_mono_ns;
+    UNIT_TEST_GENERATOR_INTEGER = 0,
 
     /**
-     * Monotonic execution time of the test case.
+     * A buffer of arbitrary bytes, whose length is in the range [min, max].
      */
-    time_t elapsed_time_mono_ns;
+    UNIT_TEST_GENERATOR_BYTES,
 
-} unit_test_case_result_t;
+    /**
+     * A NUL-terminated string of printable ASCII characters, whose length is in the range [min, max].
+     */
+    UNIT_TEST_GENERATOR_STRING
+
+} unit_test_generator_kind_t;
 
 /**
- * Internal structure that describes a single unit test case.
+ * The description of an input of a property.
  */
 typedef struct
 {
     /**
-     * Since we are using a globally allocated array of these objects,
-     * this is true, only if this object actually represents a test case.
+     * The kind of input to generate.
      */
-    bool allocated;
+    unit_test_generator_kind_t kind;
 
     /**
-     * True, only if this test shall be run when executing the unit tests.
+     * The minimum value of an integer, or the minimum length of a buffer or string.
      */
-    bool enabled;
+    int64_t min;
 
     /**
-     * This is the name of the test suite that the test case is a part of.
+     * The maximum value of an integer, or the maximum length of a buffer or string.
      */
-    const char* suite;
+    int64_t max;
 
+} unit_test_generator_t;
+
+/**
+ * A generated input of a property.
+ */
+typedef struct
+{
     /**
-     * This is the name of the test case itself.
+     * The value of an integer input.
      */
-    const char* name;
+    int64_t integer;
 
     /**
-     * This is the test case itself, which will be executed.
+     * The content of a buffer or string input, which is only valid during the run of the property.
      */
-    unit_test_function_t function;
+    const uint8_t* bytes;
 
     /**
-     * This is the result of the last execution of the test case, if any.
+     * The length of a buffer or string input, excluding the NUL-terminator of a string.
      */
-    unit_test_case_result_t result;
+    size_t length;
+
+} unit_test_value_t;
+
+/**
+ * Signature of a property function, which is invoked with one generated value per generator.
+ */
+typedef void (*unit_test_property_function_t)(const unit_test_value_t* values);
+
+/**
+ * Signature of a concurrent test case function, which is invoked by every thread at once,
+ * with the zero-based index of the invoking thread.
+ */
+typedef void (*unit_test_concurrent_function_t)(int32_t thread);
+
+/**
+ * Signature of a complexity test case function, which performs the operation on an input of size n.
+ */
+typedef void (*unit_test_complexity_function_t)(int64_t n);
+
+/**
+ * The growth models, against which the cost of a complexity test case is fitted, from best to worst.
+ */
+typedef enum
+{
+    O_1 = 0,
+    O_LOG_N,
+    O_N,
+    O_N_LOG_N,
+    O_N_SQUARED,
+    O_2_N
+
+} unit_test_complexity_t;
 
+/**
+ * The time consumed by a phase (setup, body, or teardown) of a test case.
+ */
+typedef struct
+{
     /**
-     * This is a function to invoke immediately before the unit-test,
-     * to allocate any global resources used by the unit-test case.
+     * Monotonic wall time, in nanoseconds.
      */
-    unit_test_function_t setup;
+    int64_t wall_ns;
 
     /**
-     * This is a function to invoke immediately after the unit-test,
-     * to deallocate any global resources used by the unit-test case.
+     * CPU time of the executing thread, in nanoseconds.
      */
-    unit_test_function_t teardown;
+    int64_t cpu_ns;
 
-} unit_test_case_t;
+} unit_test_phase_time_t;
 
 /**
- * A private function used to implement varadic error messages in assertions.
+ * The heap allocations made by the test case, or phase thereof.
  */
-void unit_test_fail (const char* file, int32_t line, bool has_message, ...);
+typedef struct
+{
+    /**
+     * The number of allocations, including reallocations.
+     */
+    uint64_t allocations;
+
+    /**
+     * The number of deallocations, including reallocations.
+     */
+    uint64_t frees;
+
+    /**
+     * The total number of bytes requested by the allocations.
+     */
+    uint64_t allocated_bytes;
+
+    /**
+     * The net change in the number of allocated bytes.
+     * This may be negative, if memory allocated earlier was freed.
+     */
+    int64_t live_bytes;
+
+    /**
+     * The number of bytes of the blocks that were allocated by the test case, or phase thereof,
+     * which are still allocated, regardless of any memory allocated earlier that was freed.
+     */
+    int64_t leaked_bytes;
+
+    /**
+     * The maximum net change in the number of allocated bytes.
+     */
+    int64_t peak_live_bytes;
+
+} unit_test_allocations_t;
 
 /**
- * A private function used to implement the declaration of test cases.
+ * The performance counters measured around the body of a test case.
  */
-void unit_test_declare (const char* suite,
-                        const char* name,
-                        unit_test_function_t function,
-                        unit_test_function_t setup,
-                        unit_test_function_t teardown);
+typedef struct
+{
+    /**
+     * True, if the counters were measured.
+     */
+    bool valid;
 
-int32_t unit_test_get_current ();
+    /**
+     * True, if the hardware counters were measured; otherwise,
+     * only the task-clock software counter was measured.
+     */
+    bool hardware;
 
-unit_test_case_t* unit_test_get_cases ();
+    /**
+     * The number of CPU cycles.
+     */
+    uint64_t cycles;
+
+    /**
+     * The number of instructions retired, which is far more stable across runs than the time.
+     */
+    uint64_t instructions;
+
+    /**
+     * The number of last level cache misses.
+     */
+    uint64_t cache_misses;
+
+    /**
+     * The number of mispredicted branches.
+     */
+    uint64_t branch_misses;
+
+    /**
+     * The CPU time of the task, in nanoseconds, which is only measured in lieu of the hardware counters.
+     */
+    uint64_t task_clock_ns;
+
+} unit_test_perf_counters_t;
+
+/**
+ * The statistics of a benchmark, wherein each sample is the mean time per operation,
+ * over a batch of operations, which is sized to dwarf the overhead of the clock.
+ */
+typedef struct
+{
+    /**
+     * The number of timed samples.
+     */
+    uint32_t samples;
+
+    /**
+     * The number of operations per sample.
+     */
+    uint64_t batch;
+
+    /**
+     * The total number of operations that were timed, excluding the warmup.
+     */
+    uint64_t iterations;
+
+    /**
+     * The fastest sample, in nanoseconds per operation.
+     */
+    double min_ns;
+
+    /**
+     * The median sample, in nanoseconds per operation.
+     */
+    double median_ns;
+
+    /**
+     * The 99th percentile sample, in nanoseconds per operation.
+     */
+    double p99_ns;
+
+    /**
+     * The median absolute deviation of the samples from the median,
+     * in nanoseconds per operation, which is a noise estimate that
+     * is robust to the outliers caused by interrupts and preemption.
+     */
+    double mad_ns;
+
+    /**
+     * The number of operations per second, based on the median.
+     */
+    double ops_per_second;
+
+} unit_test_bench_result_t;
+
+/**
+ * The outcome of the rows of a table-driven test case.
+ */
+typedef struct
+{
+    /**
+     * The number of rows that were executed.
+     */
+    int64_t rows;
+
+    /**
+     * The number of rows that failed.
+     */
+    int64_t failed_rows;
+
+    /**
+     * The index of the first row that failed, or -1.
+     */
+    int64_t first_failed_row;
+
+} unit_test_table_result_t;
+
+/**
+ * The outcome of the runs of a property.
+ */
+typedef struct
+{
+    /**
+     * The seed of the pseudo-random generator, which reproduces the runs.
+     */
+    uint64_t seed;
+
+    /**
+     * The number of times that the property was run, excluding the shrinking.
+     */
+    uint64_t runs;
+
+    /**
+     * The number of times that the counterexample, if any, was successfully shrunk.
+     */
+    uint64_t shrinks;
+
+    /**
+     * True, if a counterexample was found.
+     */
+    bool falsified;
+
+} unit_test_property_result_t;
+
+/**
+ * The outcome and timings of the rounds of a concurrent test case.
+ */
+typedef struct
+{
+    /**
+     * The number of threads, which ran the function at once.
+     */
+    int32_t threads;
+
+    /**
+     * The number of rounds that were executed.
+     */
+    int32_t rounds;
+
+    /**
+     * The number of times that the function failed on any thread.
+     */
+    int32_t failures;
+
+    /**
+     * The time from the first thread starting to the last thread finishing a round, in nanoseconds.
+     */
+    int64_t round_median_ns;
+    int64_t round_max_ns;
+
+    /**
+     * The time of one invocation of the function on one thread, in nanoseconds.
+     */
+    int64_t thread_median_ns;
+    int64_t thread_max_ns;
+
+    /**
+     * The time from the first thread starting to the last thread starting a round, in nanoseconds.
+     */
+    int64_t skew_median_ns;
+    int64_t skew_max_ns;
+
+} unit_test_concurrent_result_t;
+
+/**
+ * The measurements of a complexity test case, and the growth model that fits them best.
+ */
+typedef struct
+{
+    /**
+     * The number of input sizes that were measured, which are successive powers of two, from the smallest input size.
+     * The cost at each size is kept in the test case, rather than herein, so that the result of every test case stays small.
+     */
+    int32_t sizes;
+
+    /**
+     * True, if the cost is the number of instructions retired; otherwise, the cost is the time in nanoseconds.
+     */
+    bool instructions;
+
+    /**
+     * The growth model that fits the costs best, and the coefficient thereof.
+     */
+    unit_test_complexity_t fit;
+    double coefficient;
+
+    /**
+     * The root mean square error of the fit, relative to the cost at each size.
+     */
+    double rms;
+
+    /**
+     * True, if the function declared a bound via assertComplexityAtMost(), which is then the bound.
+     */
+    bool bounded;
+    unit_test_complexity_t bound;
+
+} unit_test_complexity_result_t;
+
+/**
+ * The location and message of the first assertion that failed in a test case.
+ */
+typedef struct
+{
+    /**
+     * The line of the assertion, or zero, if no assertion failed.
+     */
+    int32_t line;
+
+    /**
+     * The file of the assertion, which is truncated, if too long.
+     */
+    char file[UNIT_TEST_MAX_FAILURE_FILE];
+
+    /**
+     * The message of the assertion, if any, which is truncated, if too long.
+     */
+    char message[UNIT_TEST_MAX_FAILURE_MESSAGE];
+
+} unit_test_failure_t;
+
+/**
+ * The results of running a single unit test case.
+ */
+typedef struct
+{
+    /**
+     * True, if the test case passed and did not fail.
+     */
+    bool passed;
+
+    /**
+     * Monotonic time of when the test case began execution.
+     */
+    int64_t start_time_mono_ns;
+
+    /**
+     * Monotonic time of when the test case finished execution.
+     */
+    int64_t end_time_mono_ns;
+
+    /**
+     * Monotonic execution time of the test case.
+     */
+    int64_t elapsed_time_mono_ns;
+
+    /**
+     * Thread CPU time consumed by the test case, including the setup and teardown.
+     */
+    int64_t cpu_time_ns;
+
+    /**
+     * The time consumed by the setup function, if any.
+     */
+    unit_test_phase_time_t setup_time;
+
+    /**
+     * The time consumed by the test case itself.
+     */
+    unit_test_phase_time_t body_time;
+
+    /**
+     * The time consumed by the teardown function, if any.
+     */
+    unit_test_phase_time_t teardown_time;
+
+    /**
+     * If the process executing the test case was terminated by a signal,
+     * before the test case could finish, then this is the signal number;
+     * otherwise, this is zero.
+     */
+    int32_t signal;
+
+    /**
+     * True, if the test case was killed, because it exceeded the timeout.
+     */
+    bool timed_out;
+
+    /**
+     * If the test case is a benchmark, then these are the statistics thereof.
+     */
+    unit_test_bench_result_t bench;
+
+    /**
+     * If the test case is table-driven, then this is the outcome of the rows thereof.
+     */
+    unit_test_table_result_t table;
+
+    /**
+     * If the test case is a property, then this is the outcome of the runs thereof.
+     */
+    unit_test_property_result_t property;
+
+    /**
+     * If the test case is concurrent, then these are the timings of the rounds thereof.
+     */
+    unit_test_concurrent_result_t concurrent;
+
+    /**
+     * If the test case is a complexity test case, then these are the measurements thereof.
+     */
+    unit_test_complexity_result_t complexity;
+
+    /**
+     * The heap allocations made by the test case, including the setup and teardown.
+     */
+    unit_test_allocations_t allocations;
+
+    /**
+     * The change in the number of open file descriptors, if resources are tracked.
+     */
+    int32_t descriptor_delta;
+
+    /**
+     * The maximum resident set size of the process, in kilobytes, if resources are tracked.
+     */
+    int64_t max_rss_kb;
+
+    /**
+     * The performance counters of the body of the test case, if measured.
+     * For a benchmark, these only cover the timed samples, excluding the warmup.
+     */
+    unit_test_perf_counters_t perf;
+
+    /**
+     * The first assertion that failed, if any.
+     * This is copied, so that it survives the worker process that executed the test case.
+     */
+    unit_test_failure_t failure;
+
+} unit_test_case_result_t;
+
+/**
+ * Internal structure that describes a single unit test case.
+ */
+typedef struct
+{
+    /**
+     * This is the name of the test suite that the test case is a part of.
+     */
+    const char* suite;
+
+    /**
+     * This is the name of the test case itself.
+     */
+    const char* name;
+
+    /**
+     * This is the result of the last execution of the test case, if any.
+     */
+    unit_test_case_result_t result;
+
+    /**
+     * If the test case is table-driven, then this is the function to invoke per row.
+     */
+    unit_test_row_function_t row_function;
+
+    /**
+     * If the rows are a static array, then this is the array; otherwise, this is NULL.
+     */
+    const void* table;
+
+    /**
+     * If the rows are a static array, then this is the number of elements therein.
+     */
+    int64_t row_count;
+
+    /**
+     * If the rows are a static array, then this is the size of each element therein.
+     */
+    size_t row_size;
+
+    /**
+     * If the rows are the lines of a data file, then this is the path thereof; otherwise, this is NULL.
+     */
+    const char* data_path;
+
+    /**
+     * If the rows are the lines of a data file, then this is the source file that declared the test case,
+     * relative to the directory of which a relative path is resolved.
+     */
+    const char* data_source;
+
+    /**
+     * If the test case is a property, then this is the function to invoke per run.
+     */
+    unit_test_property_function_t property_function;
+
+    /**
+     * If the test case is a property, then these describe the inputs thereof.
+     */
+    unit_test_generator_t generators[UNIT_TEST_MAX_GENERATORS];
+
+    /**
+     * If the test case is a property, then this is the number of inputs thereof.
+     */
+    int32_t generator_count;
+
+    /**
+     * If the test case is concurrent, then this is the function to invoke on each thread.
+     */
+    unit_test_concurrent_function_t concurrent_function;
+
+    /**
+     * If the test case is concurrent, then this is the number of threads.
+     */
+    int32_t threads;
+
+    /**
+     * If the test case is a complexity test case, then this is the function to invoke per input size.
+     */
+    unit_test_complexity_function_t complexity_function;
+
+    /**
+     * If the test case is a complexity test case, then these are the smallest and largest input sizes.
+     */
+    int64_t min_n;
+    int64_t max_n;
+
+    /**
+     * If the test case is a complexity test case, then these are the cost of one call of the function at each input size,
+     * which is the fastest of the samples; otherwise, this is null.
+     */
+    double* complexity_cost;
+
+    /**
+     * This is the test module (shared object) that declared the test case, numbered from one, or zero for the program.
+     * The test cases of a module are forgotten, when the module is reloaded.
+     */
+    int32_t module;
+
+} unit_test_case_t;
+
+/**
+ * The totals of a run of the unit tests, which are passed to the reporters at the end thereof.
+ */
+typedef struct
+{
+    /**
+     * The number of test cases that passed or failed.
+     */
+    int32_t passed;
+    int32_t failed;
+
+    /**
+     * The sum of the monotonic execution times of the test cases.
+     */
+    int64_t elapsed_time_mono_ns;
+
+    /**
+     * The sum of the CPU times of the test cases.
+     */
+    int64_t cpu_time_ns;
+
+    /**
+     * The monotonic time from the start to the end of the run, which is less than the sum, if run in parallel.
+     */
+    int64_t wall_time_mono_ns;
+
+    /**
+     * The number of worker processes, which executed the test cases.
+     */
+    int32_t jobs;
+
+    /**
+     * True, if the run succeeded, namely every test case passed, every fixture succeeded, and no test case regressed.
+     */
+    bool succeeded;
+
+} unit_test_run_summary_t;
+
+/**
+ * A reporter, which writes the results of the test cases to the output, in some format.
+ * Any of the callbacks may be NULL. The callbacks are only invoked in the process,
+ * which runs the unit tests, even if the test cases are executed by workers,
+ * and the result of each test case is complete, when end_case is invoked.
+ * The exception is the reporter named text, which writes the console report to the standard output,
+ * interleaved with the output of the test cases, and is therefore invoked by the process that executes each test case.
+ */
+typedef struct
+{
+    /**
+     * Invoked once, before any test case, with the number of enabled test cases.
+     */
+    void (*start_run)(FILE* output, int32_t count);
+
+    /**
+     * Invoked before each test case, which may be executed elsewhere.
+     */
+    void (*start_case)(FILE* output, const unit_test_case_t* test_case);
+
+    /**
+     * Invoked after each test case, including the test cases that were skipped.
+     */
+    void (*end_case)(FILE* output, const unit_test_case_t* test_case);
+
+    /**
+     * Invoked once, after all of the test cases.
+     */
+    void (*end_run)(FILE* output, const unit_test_run_summary_t* summary);
+
+} unit_test_reporter_t;
+
+/**
+ * The kinds of test cases, which differ in how the function thereof is invoked.
+ */
+typedef enum
+{
+    /**
+     * The function is invoked once.
+     */
+    UNIT_TEST_KIND_TEST = 0,
+
+    /**
+     * The function is a single operation, which is invoked repeatedly and timed.
+     */
+    UNIT_TEST_KIND_BENCH,
+
+    /**
+     * The function is invoked once per row of a static array or data file.
+     */
+    UNIT_TEST_KIND_TABLE,
+
+    /**
+     * The function is invoked repeatedly with generated inputs, which are shrunk upon failure.
+     */
+    UNIT_TEST_KIND_PROPERTY,
+
+    /**
+     * The function is invoked by several threads at once, repeatedly, in rounds.
+     */
+    UNIT_TEST_KIND_CONCURRENT,
+
+    /**
+     * The function is invoked with inputs of geometrically increasing size, and the cost is fitted to a growth model.
+     */
+    UNIT_TEST_KIND_COMPLEXITY
+
+} unit_test_kind_t;
+
+/**
+ * Internal structure that describes a self-registered test case,
+ * which the linker collects into a table, along with all of the others.
+ */
+typedef struct
+{
+    /**
+     * These are the names of the test suite and test case.
+     */
+    const char* suite;
+    const char* name;
+
+    /**
+     * These are the test case itself, and the setup and teardown functions thereof, if any.
+     */
+    unit_test_function_t function;
+    unit_test_function_t setup;
+    unit_test_function_t teardown;
+
+    /**
+     * This is the kind of test case, which determines how the function is invoked.
+     */
+    unit_test_kind_t kind;
+
+    /**
+     * This is where the test case was defined, which determines the order of the test cases,
+     * since the compiler need not emit the descriptors in the order of definition.
+     */
+    const char* file;
+    int32_t line;
+
+} unit_test_descriptor_t;
+
+/**
+ * A span that was begun via UNIT_TRACE_SCOPE, which is recorded at the end of the enclosing block.
+ */
+typedef struct
+{
+    /**
+     * The name of the span, which must be a string constant, since it is only read when the trace is written.
+     */
+    const char* name;
+
+    /**
+     * Monotonic time of when the span began, or -1, if not tracing.
+     */
+    int64_t start_time_mono_ns;
+
+} unit_test_trace_scope_t;
+
+/**
+ * Internal structure that describes the parts of a single unit test case,
+ * which are accessed when selecting and executing the test cases.
+ * These are stored apart from the rarely accessed names and results.
+ */
+typedef struct
+{
+    /**
+     * True, only if this test shall be run when executing the unit tests.
+     */
+    bool enabled;
+
+    /**
+     * True, if the test case runs against the virtual clock, rather than the real one.
+     */
+    bool virtual_time;
+
+    /**
+     * This is the kind of test case, which determines how the function is invoked.
+     */
+    unit_test_kind_t kind;
+
+    /**
+     * This is the test case itself, which will be executed.
+     */
+    unit_test_function_t function;
+
+    /**
+     * This is a function to invoke immediately before the unit-test,
+     * to allocate any global resources used by the unit-test case.
+     */
+    unit_test_function_t setup;
+
+    /**
+     * This is a function to invoke immediately after the unit-test,
+     * to deallocate any global resources used by the unit-test case.
+     */
+    unit_test_function_t teardown;
+
+} unit_test_case_hot_t;
+
+/**
+ * A private function used to implement varadic error messages in assertions.
+ */
+void unit_test_fail (const char* file, int32_t line, bool has_message, ...);
+
+/**
+ * A private function used to implement the assertions that compare strings and buffers,
+ * which reports where and how the strings or buffers differ.
+ */
+void unit_test_fail_mismatch (const char* file,
+                              int32_t line,
+                              const void* expected,
+                              size_t expected_length,
+                              const void* actual,
+                              size_t actual_length,
+                              bool has_message,
+                              ...);
+
+/**
+ * A private function used to implement the declaration of test cases.
+ */
+void unit_test_declare (const char* suite,
+                        const char* name,
+                        unit_test_function_t function,
+                        unit_test_function_t setup,
+                        unit_test_function_t teardown);
+
+/**
+ * A private function used to implement the declaration of test cases, which run against the virtual clock.
+ */
+void unit_test_declare_virtual (const char* suite,
+                                const char* name,
+                                unit_test_function_t function,
+                                unit_test_function_t setup,
+                                unit_test_function_t teardown);
+
+/**
+ * A private function used to implement the declaration of benchmarks.
+ */
+void unit_test_declare_bench (const char* suite,
+                              const char* name,
+                              unit_test_function_t function,
+                              unit_test_function_t setup,
+                              unit_test_function_t teardown);
+
+/**
+ * A private function used to implement the declaration of table-driven test cases,
+ * whose rows are the elements of a static array.
+ */
+void unit_test_declare_table (const char* suite,
+                              const char* name,
+                              unit_test_row_function_t function,
+                              const void* table,
+                              int64_t row_count,
+                              size_t row_size);
+
+/**
+ * A private function used to implement the declaration of table-driven test cases,
+ * whose rows are the lines of a data file, which is memory-mapped when executed.
+ */
+void unit_test_declare_data_file (const char* suite,
+                                  const char* name,
+                                  unit_test_row_function_t function,
+                                  const char* path,
+                                  const char* source);
+
+/**
+ * A private function used to implement the declaration of property-based test cases.
+ */
+void unit_test_declare_property (const char* suite,
+                                 const char* name,
+                                 unit_test_property_function_t function,
+                                 const unit_test_generator_t* generators,
+                                 int32_t generator_count);
+
+/**
+ * A private function used to implement the declaration of concurrent test cases.
+ */
+void unit_test_declare_concurrent (const char* suite,
+                                   const char* name,
+                                   unit_test_concurrent_function_t function,
+                                   int32_t threads);
+
+/**
+ * A private function used to implement the declaration of complexity test cases.
+ */
+void unit_test_declare_complexity (const char* suite,
+                                   const char* name,
+                                   unit_test_complexity_function_t function,
+                                   int64_t min_n,
+                                   int64_t max_n);
+
+/**
+ * A private function used to implement assertComplexityAtMost().
+ */
+void unit_test_bound_complexity (const char* file, int32_t line, unit_test_complexity_t bound);
+
+/**
+ * A private function used to implement the declaration of global fixtures,
+ * which are invoked once per run, rather than once per test case.
+ */
+void unit_test_declare_global (unit_test_function_t setup, unit_test_function_t teardown);
+
+/**
+ * A private function used to implement the declaration of suite fixtures,
+ * which are invoked once per suite, rather than once per test case.
+ */
+void unit_test_declare_suite (const char* suite, unit_test_function_t setup, unit_test_function_t teardown);
+
+/**
+ * Declare a reporter, which is selected by the given name via --reporter.
+ * Declaring a reporter named text replaces the console report, which is the default.
+ * The reporter must remain valid, until the unit tests finish.
+ */
+void unit_test_declare_reporter (const char* name, const unit_test_reporter_t* reporter);
+
+int32_t unit_test_get_current ();
+
+/**
+ * Get the heap allocations made so far by the current phase
+ * (setup, body, or teardown) of the test case that is executing.
+ */
+const unit_test_allocations_t* unit_test_get_allocations ();
+
+/**
+ * A private function used to implement the allocation assertions, which obtains the allocations,
+ * like unit_test_get_allocations(), once they are counted, or fails, if they cannot be counted.
+ */
+const unit_test_allocations_t* unit_test_check_allocations (const char* file, int32_t line);
+
+/**
+ * Allocate memory from the arena, which is owned by the harness and aligned to UNIT_TEST_ARENA_ALIGNMENT.
+ * The memory that is allocated by a test case, including the setup and teardown thereof,
+ * is released at once after the teardown, even if an assertion failed, and must not be freed.
+ * The return value is NULL, if the memory could not be allocated.
+ */
+void* unit_test_alloc (size_t size);
+
+/**
+ * Allocate zeroed memory for an array from the arena.
+ */
+void* unit_test_calloc (size_t count, size_t size);
+
+/**
+ * Copy a buffer into the arena.
+ */
+void* unit_test_memdup (const void* buffer, size_t size);
+
+/**
+ * Copy a string into the arena.
+ */
+char* unit_test_strdup (const char* text);
+
+/**
+ * Get the time of the virtual clock, in nanoseconds, which starts at the time of the real monotonic clock,
+ * when a virtual-time test case starts, and only advances when advanced, or when the test case sleeps.
+ * Outside of a virtual-time test case, this is the time of the real monotonic clock.
+ */
+int64_t unit_test_clock_now ();
+
+/**
+ * Advance the virtual clock by the given number of nanoseconds, if a virtual-time test case is executing.
+ */
+void unit_test_clock_advance (int64_t ns);
+
+/**
+ * A private function used to implement UNIT_TRACE_SCOPE, which begins a span.
+ */
+unit_test_trace_scope_t unit_test_begin_trace_scope (const char* name);
+
+/**
+ * A private function used to implement UNIT_TRACE_SCOPE, which records a span at the end of the block thereof.
+ */
+void unit_test_end_trace_scope (unit_test_trace_scope_t* scope);
+
+/**
+ * Get the descriptions of the declared test cases, in the order of declaration.
+ * The table may move, when more test cases are declared.
+ */
+unit_test_case_t* unit_test_get_cases ();
+
+/**
+ * Get the number of declared test cases.
+ */
+int32_t unit_test_get_case_count ();
 
 /**
  * Invoke this function in order to run the unit tests.